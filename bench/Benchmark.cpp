@@ -0,0 +1,104 @@
+#include "Benchmark.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace {
+    struct Entry {
+        const char* name;
+        bench::BenchmarkFn fn;
+    };
+
+    std::vector<Entry>& registry() {
+        static std::vector<Entry> entries;
+        return entries;
+    }
+
+    constexpr int REPETITIONS = 5;
+
+    double runOnce(bench::BenchmarkFn fn, uint64_t iterations) {
+        bench::State state(iterations);
+        fn(state);
+        return static_cast<double>(state.elapsed().count());
+    }
+}
+
+namespace bench {
+
+State::State(uint64_t iterations)
+    : iters(iterations), started(Clock::now())
+{
+}
+
+void State::pauseTiming() {
+    if (!timing) return;
+    accumulated += Clock::now() - started;
+    timing = false;
+}
+
+void State::resumeTiming() {
+    if (timing) return;
+    started = Clock::now();
+    timing = true;
+}
+
+std::chrono::nanoseconds State::elapsed() const {
+    return timing ? accumulated + (Clock::now() - started) : accumulated;
+}
+
+Registration::Registration(const char* name, BenchmarkFn fn) {
+    registry().push_back({name, fn});
+}
+
+}  // namespace bench
+
+// Usage: stepper_bench [--min-time-ms=N] [name-filter]
+int main(int argc, char* argv[]) {
+    const char* filter = nullptr;
+    double minTimeNs = 200e6;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strncmp(argv[i], "--min-time-ms=", 14) == 0) {
+            minTimeNs = std::atof(argv[i] + 14) * 1e6;
+        } else {
+            filter = argv[i];
+        }
+    }
+
+    auto& entries = registry();
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return std::strcmp(a.name, b.name) < 0; });
+
+    std::cout << std::left << std::setw(36) << "benchmark"
+              << std::right << std::setw(14) << "iterations"
+              << std::setw(14) << "median ns/op"
+              << std::setw(14) << "min ns/op" << '\n';
+
+    for (const auto& entry : entries) {
+        if (filter && !std::strstr(entry.name, filter)) continue;
+
+        // Calibrate: grow the count until one run takes a tenth of the budget
+        uint64_t iterations = 1;
+        double elapsedNs = runOnce(entry.fn, iterations);
+        while (elapsedNs < minTimeNs / 10 && iterations < (1ULL << 40)) {
+            iterations *= (elapsedNs > 0) ? std::clamp<uint64_t>(static_cast<uint64_t>(minTimeNs / 10 / elapsedNs) + 1, 2, 100) : 100;
+            elapsedNs = runOnce(entry.fn, iterations);
+        }
+        iterations = std::max<uint64_t>(1, static_cast<uint64_t>(iterations * (minTimeNs / std::max(elapsedNs, 1.0))));
+
+        std::vector<double> perOp;
+        for (int rep = 0; rep < REPETITIONS; ++rep) {
+            perOp.push_back(runOnce(entry.fn, iterations) / static_cast<double>(iterations));
+        }
+        std::sort(perOp.begin(), perOp.end());
+
+        std::cout << std::left << std::setw(36) << entry.name
+                  << std::right << std::setw(14) << iterations
+                  << std::setw(14) << std::fixed << std::setprecision(1) << perOp[REPETITIONS / 2]
+                  << std::setw(14) << perOp.front() << '\n';
+    }
+    return 0;
+}
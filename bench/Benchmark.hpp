@@ -0,0 +1,61 @@
+#pragma once
+#include <chrono>
+#include <cstdint>
+
+// ─── Minimal in-house benchmark harness ─────────────────────────────────────
+//
+//  Each benchmark is a function taking a State; it runs its workload
+//  state.iterations() times.  The runner calibrates the iteration count to
+//  a fixed time budget, repeats the measurement and reports ns/op.
+//
+//      void BM_Something(bench::State& state) {
+//          for (uint64_t i = 0; i < state.iterations(); ++i) {
+//              bench::doNotOptimize(work());
+//          }
+//      }
+//      BENCHMARK(BM_Something);
+//
+//  Setup that must not be timed goes between pauseTiming()/resumeTiming().
+//
+namespace bench {
+
+class State {
+public:
+    explicit State(uint64_t iterations);
+
+    uint64_t iterations() const { return iters; }
+
+    void pauseTiming();
+    void resumeTiming();
+
+    /// Timed wall-clock duration so far.
+    std::chrono::nanoseconds elapsed() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    uint64_t iters;
+    Clock::time_point started;
+    std::chrono::nanoseconds accumulated{0};
+    bool timing = true;
+};
+
+using BenchmarkFn = void (*)(State&);
+
+struct Registration {
+    Registration(const char* name, BenchmarkFn fn);
+};
+
+// Keep the compiler from discarding a computed value or hoisting the work.
+template <typename T>
+inline void doNotOptimize(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+inline void clobberMemory() {
+    asm volatile("" : : : "memory");
+}
+
+}  // namespace bench
+
+#define BENCHMARK(fn) static ::bench::Registration fn##Registration(#fn, fn)
@@ -0,0 +1,25 @@
+#include "Benchmark.hpp"
+#include "ControlPacket.hpp"
+
+namespace {
+
+// Validate + decode one binary datagram (CRC included).
+void BM_ControlPacketDecode(bench::State& state) {
+    ControlPacket packet;
+    packet.leftX = 8192;
+    packet.leftY = -16384;
+    packet.rightX = -24576;
+    packet.rightY = 4096;
+    packet.buttons = 0x5;
+    uint8_t datagram[CONTROL_PACKET_SIZE];
+    encodeControlPacket(packet, datagram);
+
+    ControlPacket decoded;
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        bench::doNotOptimize(decodeControlPacket(datagram, sizeof(datagram), decoded));
+        bench::doNotOptimize(decoded.leftX);
+    }
+}
+BENCHMARK(BM_ControlPacketDecode);
+
+}  // namespace
@@ -0,0 +1,34 @@
+#include "Benchmark.hpp"
+#include "InputArbiter.hpp"
+
+namespace {
+
+// What the control loop pays per update: one consistent copy of all axes.
+void BM_InputSnapshotRead(bench::State& state) {
+    InputArbiter arbiter;
+    InputState input;
+    input.axes[0] = 8192;
+    input.axes[1] = -16384;
+    arbiter.setClient(0, input, 0);
+
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        const InputSnapshot snap = arbiter.snapshot();
+        bench::doNotOptimize(snap.axes[0]);
+        bench::doNotOptimize(snap.axes[1]);
+    }
+}
+BENCHMARK(BM_InputSnapshotRead);
+
+// What a packet pays: re-run the selection and publish.
+void BM_InputArbiterPublish(bench::State& state) {
+    InputArbiter arbiter;
+    InputState input;
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        input.axes[0] = static_cast<int16_t>(i);
+        arbiter.setClient(0, input, i);
+    }
+    bench::doNotOptimize(arbiter.snapshot().axes[0]);
+}
+BENCHMARK(BM_InputArbiterPublish);
+
+}  // namespace
@@ -0,0 +1,40 @@
+#include "Benchmark.hpp"
+#include "ControlPacket.hpp"
+#include "InputManager.hpp"
+
+namespace {
+
+// A typical datagram from the client (see readme, "JSON Packet Format").
+constexpr char kControlPacket[] =
+    "{\"joysticks\":{\"left\":[0.25,-0.5],\"right\":[-0.75,0.125]}}";
+
+void BM_InputJsonPacket(bench::State& state) {
+    InputManager input;
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        bench::doNotOptimize(input.applyJsonPacket(kControlPacket));
+    }
+}
+BENCHMARK(BM_InputJsonPacket);
+
+// The same stick positions in the binary format.  Each packet needs a
+// fresh sequence number to get past the reordering check, so the encode
+// (one CRC) is part of the measured time.
+void BM_InputBinaryPacket(bench::State& state) {
+    ControlPacket packet;
+    packet.leftX = 8192;
+    packet.leftY = -16384;
+    packet.rightX = -24576;
+    packet.rightY = 4096;
+    char datagram[CONTROL_PACKET_SIZE];
+
+    InputManager input;
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        packet.sequence = static_cast<uint32_t>(i + 1);
+        packet.sentUs = static_cast<uint32_t>(i * 5000);
+        encodeControlPacket(packet, reinterpret_cast<uint8_t*>(datagram));
+        bench::doNotOptimize(input.applyPacket(datagram, sizeof(datagram)));
+    }
+}
+BENCHMARK(BM_InputBinaryPacket);
+
+}  // namespace
@@ -0,0 +1,71 @@
+#include "Benchmark.hpp"
+#include "LedController.hpp"
+#include <vector>
+
+// Friend of LedController: reaches the private SPI frame encoder.
+class LedControllerBench {
+public:
+    static void buildSpiFrame(LedController& leds, std::vector<uint8_t>& frame) {
+        frame.resize(leds.frameBytes());
+        leds.buildSpiFrame(leds.pixels, frame.data());
+    }
+};
+
+namespace {
+
+// Full 144-pixel frame, mixed colours so every bit pattern is exercised.
+void buildSpiFrameWith(bench::State& state, LedEncoding encoding) {
+    LedStripConfig config;
+    config.encoding = encoding;
+    LedController leds(config);
+    for (uint16_t i = 0; i < leds.pixelCount(); ++i) {
+        leds.setPixel(i, static_cast<uint8_t>(i * 7), static_cast<uint8_t>(i * 13), static_cast<uint8_t>(i * 29));
+    }
+    leds.setBrightness(Constants::LED_DEFAULT_BRIGHTNESS);
+
+    std::vector<uint8_t> frame;
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        LedControllerBench::buildSpiFrame(leds, frame);
+        bench::doNotOptimize(frame.data());
+    }
+}
+
+void BM_LedBuildSpiFrame(bench::State& state) {
+    buildSpiFrameWith(state, LedEncoding::Spi8Bit);
+}
+BENCHMARK(BM_LedBuildSpiFrame);
+
+void BM_LedBuildSpiFrame3Bit(bench::State& state) {
+    buildSpiFrameWith(state, LedEncoding::Spi3Bit);
+}
+BENCHMARK(BM_LedBuildSpiFrame3Bit);
+
+// Worst case the engine allows: every slot busy, each layer spanning the
+// whole strip, one evaluation per simulated 16 ms frame.
+void BM_LedEffectsFullTable(bench::State& state) {
+    LedEffectEngine engine;
+    const LedEffectType types[] = {
+        LedEffectType::Rainbow, LedEffectType::Breathe, LedEffectType::Chase, LedEffectType::Blink,
+        LedEffectType::EyeLook, LedEffectType::Solid,   LedEffectType::Chase, LedEffectType::EyeLook,
+    };
+    for (LedEffectType type : types) {
+        LedEffect fx;
+        fx.type = type;
+        fx.blend = LedBlend::Add;
+        fx.colour = {40, 40, 40};
+        fx.width = 6;
+        engine.add(fx);
+    }
+    engine.setLook(12000, -8000);
+
+    std::vector<Pixel> frame(Constants::LED_PIXEL_COUNT);
+    uint32_t nowMs = 0;
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        engine.render(frame.data(), static_cast<uint16_t>(frame.size()), nowMs);
+        nowMs += Constants::LED_REFRESH_INTERVAL_MS;
+        bench::doNotOptimize(frame.data());
+    }
+}
+BENCHMARK(BM_LedEffectsFullTable);
+
+}  // namespace
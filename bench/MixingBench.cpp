@@ -0,0 +1,37 @@
+#include "Benchmark.hpp"
+#include "Mixing.hpp"
+
+namespace {
+
+void BM_ScaleAxis(bench::State& state) {
+    int16_t raw = -32767;
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        bench::doNotOptimize(scaleAxis(raw));
+        raw = static_cast<int16_t>(raw + 97);
+    }
+}
+BENCHMARK(BM_ScaleAxis);
+
+void BM_CommandToSpeed(bench::State& state) {
+    int command = -512;
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        bench::doNotOptimize(commandToSpeed(command));
+        command = (command >= 512) ? -512 : command + 1;
+    }
+}
+BENCHMARK(BM_CommandToSpeed);
+
+// One control-loop tick: four axes through deadzone, mix and scaling.
+void BM_MixAxes(bench::State& state) {
+    int16_t x = 0, y = 12000, rx = -20000, ry = 5000;
+    for (uint64_t i = 0; i < state.iterations(); ++i) {
+        bench::doNotOptimize(mixAxes(x, y, rx, ry));
+        x = static_cast<int16_t>(x + 131);
+        y = static_cast<int16_t>(y - 71);
+        rx = static_cast<int16_t>(rx + 37);
+        ry = static_cast<int16_t>(ry - 53);
+    }
+}
+BENCHMARK(BM_MixAxes);
+
+}  // namespace
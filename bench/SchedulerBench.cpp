@@ -0,0 +1,50 @@
+#include "Benchmark.hpp"
+#include "MotorController.hpp"
+#include "SimulatedGpioBackend.hpp"
+#include <memory>
+#include <thread>
+
+namespace {
+
+uint64_t totalSteps(const MotorController& motors) {
+    uint64_t steps = 0;
+    for (int axis : {MotorController::LEFT, MotorController::RIGHT, MotorController::PAN, MotorController::TILT}) {
+        steps += motors.stepStats(axis).steps;
+    }
+    return steps;
+}
+
+// Wall-clock cost per step of the scheduler thread with all four axes at
+// full speed.  The simulated backend runs in virtual time, so this is pure
+// scheduler CPU: heap operations, ramp lookups and pin writes.
+void runScheduler(bench::State& state, PulseMode mode) {
+    state.pauseTiming();
+    auto backend = std::make_unique<SimulatedGpioBackend>();
+    backend->setRecording(false);
+    MotorController motors(std::move(backend));
+    motors.setPulseMode(mode);
+    motors.initialize();
+    for (int axis : {MotorController::LEFT, MotorController::RIGHT, MotorController::PAN, MotorController::TILT}) {
+        motors.setSpeed(axis, Constants::MAX_SPEED_STEPS_PER_SEC);
+    }
+
+    const uint64_t startSteps = totalSteps(motors);
+    state.resumeTiming();
+    while (totalSteps(motors) - startSteps < state.iterations()) {
+        std::this_thread::yield();
+    }
+    state.pauseTiming();
+    motors.stop();
+}
+
+void BM_SchedulerDirect(bench::State& state) {
+    runScheduler(state, PulseMode::Direct);
+}
+BENCHMARK(BM_SchedulerDirect);
+
+void BM_SchedulerPulseTrain(bench::State& state) {
+    runScheduler(state, PulseMode::PulseTrain);
+}
+BENCHMARK(BM_SchedulerPulseTrain);
+
+}  // namespace
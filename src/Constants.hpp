@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 #include <cstdint>
 
 namespace Constants {
@@ -36,17 +37,62 @@ namespace Constants {
     // WS2815 LED Strip (12 V, driven via SPI MOSI → 3.3→5 V level-shift)
     constexpr char LED_SPI_DEVICE[]      = "/dev/spidev0.0";
     constexpr uint32_t LED_SPI_SPEED_HZ  = 6'400'000;   // ≈ 800 kHz NRZ encoded as 8× SPI bits
+    constexpr uint32_t LED_SPI3_SPEED_HZ = 2'700'000;   // ≈ 900 kHz NRZ encoded as 3× SPI bits
     constexpr uint16_t LED_PIXEL_COUNT   = 144;          // BTF-LIGHTING WS2815, 3.2 ft strip
     constexpr uint8_t  LED_DEFAULT_BRIGHTNESS = 128;     // 0-255 global scalar (50 % default)
     constexpr unsigned LED_REFRESH_INTERVAL_MS = 16;     // ~60 Hz max refresh rate
+    constexpr unsigned LED_KEEPALIVE_INTERVAL_MS = 1000; // resend an unchanged frame this often (0 = never)
+    constexpr float LED_GAMMA_RED   = 2.6f;              // per-channel output gamma (1.0 = linear)
+    constexpr float LED_GAMMA_GREEN = 2.6f;
+    constexpr float LED_GAMMA_BLUE  = 2.6f;
+    constexpr bool  LED_TEMPORAL_DITHER = true;          // carry sub-LSB gamma error across frames
+    constexpr unsigned LED_DITHER_CYCLE_FRAMES = 8;      // ordered dither period (power of two): 1/8 LSB steps
+    constexpr unsigned LED_DITHER_SETTLE_FRAMES = 0;     // round a static frame after this many (0 = keep dithering)
+    constexpr unsigned LED_CHANNEL_FULL_SCALE_MA = 6;    // 12 V draw of one channel at 255 (144 px white ≈ 2.6 A)
+    constexpr unsigned LED_CURRENT_BUDGET_MA = 1500;     // strip share of the 12 V buck (0 = unlimited)
+    constexpr char LED_SEGMENT_MAP_PATH[] = "config/led_segments.conf";  // relative to the working directory
 
     // Network
     constexpr int UDP_PORT = 5005;
     constexpr int UDP_BUFFER_SIZE = 4096;
+    constexpr unsigned UDP_BATCH_SIZE = 32;              // datagrams drained per recvmmsg call
+    constexpr unsigned UDP_MAX_CLIENTS = 4;              // senders tracked separately for arbitration
+    constexpr int UDP_RECEIVE_BUFFER_BYTES = 64 * 1024;  // SO_RCVBUF request (0 = kernel default)
+    constexpr unsigned UDP_STALE_PACKET_MS = 150;        // drop packets delayed this far past the best recent one
+    constexpr unsigned UDP_STALE_REBASELINE_PACKETS = 16; // this many stale in a row: the transit level moved
+    constexpr unsigned UDP_SENDER_RESTART_MS = 1000;     // silence after which any sequence is accepted
+    constexpr unsigned UDP_DELAY_WINDOW_MS = 10000;      // window for the minimum-delay baseline
+    constexpr unsigned UDP_WATCHDOG_MS = 1000;           // silence after which the inputs are reset
+
+    // Real-time scheduling (see RealTime.hpp); boot with isolcpus=3 to
+    // dedicate the step core.
+    constexpr int RT_MOTOR_PRIORITY = 80;
+    constexpr int RT_MOTOR_CPU = 3;
+    constexpr int RT_INPUT_PRIORITY = 60;
+    constexpr int RT_INPUT_CPU = -1;                // -1 = let the kernel place input threads.
+    constexpr size_t RT_STACK_PREFAULT_BYTES = 64 * 1024;
 
     // Timing & Speed
-    constexpr int16_t MAX_SPEED_STEPS_PER_SEC = 100;
+    constexpr int16_t MAX_SPEED_STEPS_PER_SEC = 1000;   // Full-stick command; each axis ramps to it.
+
+    // Motion limits (steps/s, steps/s², steps/s³; jerk 0 = trapezoidal ramp)
+    constexpr uint32_t DRIVE_MAX_VELOCITY = 1000;
+    constexpr uint32_t DRIVE_ACCELERATION = 2000;
+    constexpr uint32_t DRIVE_JERK = 20000;          // S-curve keeps the KH56 wheels from stalling.
+    // Drive geometry for moveRelative() (measure on the robot)
+    constexpr double DRIVE_STEPS_PER_REV = 200.0;       // KH56 full steps × driver microstepping
+    constexpr double DRIVE_WHEEL_DIAMETER_MM = 100.0;
+    constexpr double DRIVE_TRACK_WIDTH_MM = 300.0;      // Wheel contact patch centre to centre.
+
+    constexpr uint32_t TURRET_MAX_VELOCITY = 1000;
+    constexpr uint32_t TURRET_ACCELERATION = 4000;
+    constexpr uint32_t TURRET_JERK = 0;
     constexpr unsigned PULSE_WIDTH_US = 20;
+    constexpr unsigned DIR_SETUP_US = 10;           // ENA/DIR change to first step edge (TB6600: >= 5 us).
+    constexpr unsigned SCHEDULER_POLL_US = 1000;    // Target re-check while moving (setSpeed() also wakes it).
+    constexpr unsigned SCHEDULER_IDLE_MS = 1000;    // Safety re-check while idle; normally woken by setSpeed().
+    constexpr unsigned PULSE_TRAIN_WINDOW_MS = 10;  // Edges rendered per lgTxWave submission.
     constexpr unsigned STEP_LED_DURATION_MS = 50;
     constexpr unsigned LOG_INTERVAL_MS = 1000;
+    constexpr unsigned STEP_DEADLINE_MISS_US = 100; // Step lateness counted as a missed deadline.
 }
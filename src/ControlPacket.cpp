@@ -0,0 +1,96 @@
+#include "ControlPacket.hpp"
+#include <array>
+
+// ─── CRC-32 ─────────────────────────────────────────────────────────────────
+
+static constexpr std::array<uint32_t, 256> makeCrcTable() {
+    std::array<uint32_t, 256> table{};
+    for (uint32_t i = 0; i < 256; ++i) {
+        uint32_t c = i;
+        for (int k = 0; k < 8; ++k) {
+            c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+        }
+        table[i] = c;
+    }
+    return table;
+}
+
+static constexpr std::array<uint32_t, 256> kCrcTable = makeCrcTable();
+
+template <typename Byte>
+static constexpr uint32_t crc32Of(const Byte* data, size_t length) {
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < length; ++i) {
+        c = kCrcTable[(c ^ static_cast<uint8_t>(data[i])) & 0xFF] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+// Standard check value for CRC-32/ISO-HDLC
+static_assert(crc32Of("123456789", 9) == 0xCBF43926u, "CRC-32 table is wrong");
+
+uint32_t crc32(const uint8_t* data, size_t length) {
+    return crc32Of(data, length);
+}
+
+// ─── Little-endian field access ─────────────────────────────────────────────
+
+static inline uint16_t readU16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+static inline uint32_t readU32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+static inline void writeU16(uint8_t* p, uint16_t v) {
+    p[0] = static_cast<uint8_t>(v);
+    p[1] = static_cast<uint8_t>(v >> 8);
+}
+
+static inline void writeU32(uint8_t* p, uint32_t v) {
+    for (int i = 0; i < 4; ++i) p[i] = static_cast<uint8_t>(v >> (8 * i));
+}
+
+// ─── Codec ──────────────────────────────────────────────────────────────────
+
+ControlPacketStatus decodeControlPacket(const uint8_t* data, size_t length, ControlPacket& out) {
+    if (length < 2 || data[0] != 'M' || data[1] != 'P') return ControlPacketStatus::NotBinary;
+    if (length < 3) return ControlPacketStatus::BadLength;
+
+    const uint8_t version = data[2];
+    size_t expected;
+    switch (version) {
+        case 1:  expected = CONTROL_PACKET_V1_SIZE; break;
+        case 2:  expected = CONTROL_PACKET_SIZE; break;
+        default: return ControlPacketStatus::BadVersion;
+    }
+    if (length != expected) return ControlPacketStatus::BadLength;
+    if (crc32(data, expected - 4) != readU32(data + expected - 4)) return ControlPacketStatus::BadCrc;
+
+    out.sequence = readU32(data + 4);
+    out.leftX    = static_cast<int16_t>(readU16(data + 8));
+    out.leftY    = static_cast<int16_t>(readU16(data + 10));
+    out.rightX   = static_cast<int16_t>(readU16(data + 12));
+    out.rightY   = static_cast<int16_t>(readU16(data + 14));
+    out.buttons  = readU32(data + 16);
+    out.hasTimestamp = version >= 2;
+    out.sentUs   = out.hasTimestamp ? readU32(data + 20) : 0;
+    return ControlPacketStatus::Ok;
+}
+
+void encodeControlPacket(const ControlPacket& packet, uint8_t* out) {
+    out[0] = 'M';
+    out[1] = 'P';
+    out[2] = CONTROL_PACKET_VERSION;
+    out[3] = 0;
+    writeU32(out + 4, packet.sequence);
+    writeU16(out + 8,  static_cast<uint16_t>(packet.leftX));
+    writeU16(out + 10, static_cast<uint16_t>(packet.leftY));
+    writeU16(out + 12, static_cast<uint16_t>(packet.rightX));
+    writeU16(out + 14, static_cast<uint16_t>(packet.rightY));
+    writeU32(out + 16, packet.buttons);
+    writeU32(out + 20, packet.sentUs);
+    writeU32(out + 24, crc32(out, 24));
+}
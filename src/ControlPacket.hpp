@@ -0,0 +1,58 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// ─── Binary UDP control packet ──────────────────────────────────────────────
+//
+//  Fixed little-endian layout, decoded in place with no allocation:
+//
+//    offset  size  field
+//       0      2   magic      'M' 'P'
+//       2      1   version    1 or 2 (CONTROL_PACKET_VERSION)
+//       3      1   flags      reserved, send 0
+//       4      4   sequence   incremented by the sender per packet
+//       8      8   axes       int16 × 4: left x, left y, right x, right y
+//                             (±32767, y up – same sense as the JSON floats)
+//      16      4   buttons    bitmask, bit n = button n held
+//    v2 only:
+//      20      4   sentUs     sender's monotonic clock in µs (wraps)
+//    then:
+//   20/24      4   crc        CRC-32 (IEEE 802.3) of all preceding bytes
+//
+//  Version 1 (24 bytes) has no timestamp; version 2 is 28 bytes.
+//
+//  JSON text can never start with 'M', so a receiver can try this format
+//  first and fall back to JSON on a magic mismatch.
+//
+constexpr uint8_t CONTROL_PACKET_VERSION = 2;
+constexpr size_t  CONTROL_PACKET_V1_SIZE = 24;
+constexpr size_t  CONTROL_PACKET_SIZE = 28;
+
+struct ControlPacket {
+    uint32_t sequence = 0;
+    int16_t  leftX = 0;
+    int16_t  leftY = 0;
+    int16_t  rightX = 0;
+    int16_t  rightY = 0;
+    uint32_t buttons = 0;
+    bool     hasTimestamp = false;  // false for version 1 packets
+    uint32_t sentUs = 0;
+};
+
+enum class ControlPacketStatus {
+    Ok,
+    NotBinary,      // magic mismatch – probably JSON
+    BadLength,
+    BadVersion,
+    BadCrc,
+};
+
+/// Validate and decode one datagram.  `out` is only written on Ok.
+ControlPacketStatus decodeControlPacket(const uint8_t* data, size_t length, ControlPacket& out);
+
+/// Encode as the current version, exactly CONTROL_PACKET_SIZE bytes (for
+/// clients and tools).
+void encodeControlPacket(const ControlPacket& packet, uint8_t* out);
+
+/// CRC-32 (IEEE 802.3, reflected, as zlib's crc32()).
+uint32_t crc32(const uint8_t* data, size_t length);
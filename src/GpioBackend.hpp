@@ -0,0 +1,49 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// One entry of a wave: apply `bits` to the group pins selected by `mask`,
+// then hold for delayUs before the next entry (mirrors lgpio's lgPulse_t).
+struct GpioPulse {
+    uint64_t bits;
+    uint64_t mask;
+    uint64_t delayUs;
+};
+
+// ─── GPIO backend ───────────────────────────────────────────────────────────
+//
+//  Everything MotorController needs from the hardware: output pins, one
+//  output group for wave transmission, and the clock the step scheduler
+//  sleeps on.  LgpioBackend drives the Pi header; SimulatedGpioBackend runs
+//  on any Linux box in virtual time and records every edge.
+//
+class GpioBackend {
+public:
+    virtual ~GpioBackend() = default;
+
+    virtual bool open() = 0;
+    virtual void close() = 0;
+
+    virtual bool claimOutput(unsigned gpio, int level) = 0;
+    virtual void write(unsigned gpio, int level) = 0;
+
+    /// Claim `gpios` as one group (gpios[0] leads); bit i of every group
+    /// mask addresses gpios[i].
+    virtual bool claimGroup(const std::vector<int>& gpios, const std::vector<int>& levels) = 0;
+    virtual void groupWrite(uint64_t bits, uint64_t mask) = 0;
+
+    /// Queue a wave on the group behind any wave already playing.
+    virtual bool submitWave(const GpioPulse* pulses, size_t count) = 0;
+    virtual int waveRoom() = 0;
+    virtual bool waveBusy() = 0;
+
+    /// Monotonic scheduler clock and an absolute sleep on it.  May return
+    /// early; callers re-check the time.
+    virtual uint64_t nowNs() = 0;
+    virtual void sleepUntilNs(uint64_t deadlineNs) = 0;
+
+    /// Make the current (or, if none, the next) sleepUntilNs() return
+    /// early.  Safe to call from any thread.
+    virtual void wake() {}
+};
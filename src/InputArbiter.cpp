@@ -0,0 +1,101 @@
+#include "InputArbiter.hpp"
+#include <cstdlib>
+
+void InputArbiter::setJoystick(const InputState& state, bool connected) {
+    std::lock_guard<std::mutex> lk(updateMutex);
+    joystick = state;
+    joystickConnected = connected;
+    publishLocked();
+}
+
+void InputArbiter::setClient(unsigned client, const InputState& state, uint64_t nowMs) {
+    if (client >= MAX_CLIENTS) return;
+    std::lock_guard<std::mutex> lk(updateMutex);
+    clients[client] = {true, nowMs, state};
+    publishLocked();
+}
+
+void InputArbiter::dropClient(unsigned client) {
+    if (client >= MAX_CLIENTS) return;
+    std::lock_guard<std::mutex> lk(updateMutex);
+    clients[client].active = false;
+    publishLocked();
+}
+
+void InputArbiter::setAutopilot(const InputState& state) {
+    std::lock_guard<std::mutex> lk(updateMutex);
+    autopilot = state;
+    autopilotActive = true;
+    publishLocked();
+}
+
+void InputArbiter::clearAutopilot() {
+    std::lock_guard<std::mutex> lk(updateMutex);
+    autopilotActive = false;
+    publishLocked();
+}
+
+unsigned InputArbiter::expire(uint64_t nowMs, uint64_t& nextExpiryMs) {
+    std::lock_guard<std::mutex> lk(updateMutex);
+    unsigned released = 0;
+    nextExpiryMs = 0;
+    for (auto& client : clients) {
+        if (!client.active) continue;
+        const uint64_t ageMs = nowMs - client.lastMs;
+        if (ageMs >= Constants::UDP_WATCHDOG_MS) {
+            client.active = false;
+            ++released;
+        } else {
+            const uint64_t leftMs = Constants::UDP_WATCHDOG_MS - ageMs;
+            if (nextExpiryMs == 0 || leftMs < nextExpiryMs) nextExpiryMs = leftMs;
+        }
+    }
+    if (released > 0) publishLocked();
+    return released;
+}
+
+bool InputArbiter::joystickEngaged() const {
+    // Only the mapped sticks count: triggers rest at full negative
+    for (int axis : {Constants::JOYSTICK_AXIS_X, Constants::JOYSTICK_AXIS_Y,
+                     Constants::JOYSTICK_AXIS_RX, Constants::JOYSTICK_AXIS_RY}) {
+        // JOYSTICK_DEADZONE is in ±512 command units
+        if (std::abs(joystick.axes[axis]) * 512 >= Constants::JOYSTICK_DEADZONE * Constants::MAX_JOYSTICK_VALUE) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void InputArbiter::publishLocked() {
+    InputSnapshot snap;
+    const InputState* winner = nullptr;
+
+    if (joystickConnected && joystickEngaged()) {
+        winner = &joystick;
+        snap.source = InputSource::Joystick;
+    } else {
+        // Sticky owner first, then the most recently heard client
+        if (udpOwner >= 0 && !clients[udpOwner].active) udpOwner = -1;
+        if (udpOwner < 0) {
+            for (unsigned i = 0; i < MAX_CLIENTS; ++i) {
+                if (clients[i].active && (udpOwner < 0 || clients[i].lastMs > clients[udpOwner].lastMs)) {
+                    udpOwner = static_cast<int>(i);
+                }
+            }
+        }
+        if (udpOwner >= 0) {
+            winner = &clients[udpOwner].state;
+            snap.source = InputSource::Udp;
+            snap.client = static_cast<uint8_t>(udpOwner);
+        } else if (autopilotActive) {
+            winner = &autopilot;
+            snap.source = InputSource::Autopilot;
+        }
+    }
+
+    if (winner) {
+        for (int i = 0; i < 8; ++i) snap.axes[i] = winner->axes[i];
+        snap.buttons = winner->buttons;
+    }
+    published.store(snap);
+}
@@ -0,0 +1,90 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <mutex>
+#include "Constants.hpp"
+#include "Seqlock.hpp"
+
+// Where the published axes came from, in ascending priority.
+enum class InputSource : uint8_t {
+    None,           // nothing eligible: all axes zero
+    Autopilot,      // scripted control, until cleared
+    Udp,            // a network client, while it keeps sending
+    Joystick,       // the local stick, while it is deflected
+};
+
+// Raw stick and button state of one source (same axis numbering and sense
+// as the joystick device).
+struct InputState {
+    int16_t axes[8] = {};
+    uint32_t buttons = 0;
+};
+
+// What the control loop sees: the winning source's state.
+struct InputSnapshot {
+    int16_t axes[8] = {};
+    uint32_t buttons = 0;
+    InputSource source = InputSource::None;
+    uint8_t client = 0;             // UDP client slot, when source == Udp
+};
+
+// ─── Input arbiter ──────────────────────────────────────────────────────────
+//
+//  Keeps one state per input source – the local joystick, each UDP client
+//  and the autopilot – and publishes the state of exactly one of them:
+//
+//    1. Only eligible sources compete.  The joystick is eligible while it
+//       is connected and a drive or turret axis is outside the deadzone, a
+//       UDP client while its last packet is under UDP_WATCHDOG_MS old, the
+//       autopilot from setAutopilot() until clearAutopilot().
+//    2. The highest-priority eligible source wins (InputSource order).
+//    3. Between UDP clients the current owner keeps control while it is
+//       eligible; otherwise the most recently heard client takes over.
+//
+//  Every update re-runs the selection and publishes one snapshot through a
+//  seqlock, so readers never block and never see axes from two sources.
+//  Updates may come from any thread; they are serialised internally.
+//
+class InputArbiter {
+public:
+    static constexpr unsigned MAX_CLIENTS = Constants::UDP_MAX_CLIENTS;
+
+    void setJoystick(const InputState& state, bool connected);
+
+    /// New state for UDP client slot `client`, heard at nowMs.
+    void setClient(unsigned client, const InputState& state, uint64_t nowMs);
+
+    /// Forget a client slot (it is about to be reused for another sender).
+    void dropClient(unsigned client);
+
+    void setAutopilot(const InputState& state);
+    void clearAutopilot();
+
+    /// Release UDP clients that have been silent for UDP_WATCHDOG_MS.
+    /// Returns how many were released; `nextExpiryMs` is set to the time
+    /// until the next client would expire, or 0 if none is active.
+    unsigned expire(uint64_t nowMs, uint64_t& nextExpiryMs);
+
+    /// Latest published snapshot.  Lock-free; callable from any thread.
+    InputSnapshot snapshot() const { return published.load(); }
+
+private:
+    struct ClientState {
+        bool active = false;
+        uint64_t lastMs = 0;
+        InputState state;
+    };
+
+    mutable std::mutex updateMutex;
+    InputState joystick;
+    bool joystickConnected = false;
+    std::array<ClientState, MAX_CLIENTS> clients;
+    int udpOwner = -1;
+    InputState autopilot;
+    bool autopilotActive = false;
+
+    Seqlock<InputSnapshot> published;
+
+    bool joystickEngaged() const;
+    void publishLocked();
+};
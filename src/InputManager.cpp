@@ -1,4 +1,5 @@
 #include "InputManager.hpp"
+#include "ControlPacket.hpp"
 #include <iostream>
 #include <fcntl.h>
 #include <unistd.h>
@@ -7,6 +8,10 @@
 #include <netinet/in.h>
 #include <arpa/inet.h>
 #include <cstring>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/timerfd.h>
 #include <nlohmann/json.hpp>
 
 #include <ifaddrs.h>
@@ -20,14 +25,30 @@ uint64_t currentMs() {
         .count();
 }
 
-InputManager::InputManager() {
-    for (int i = 0; i < 8; ++i) axes[i] = 0;
+static uint64_t currentUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+               std::chrono::steady_clock::now().time_since_epoch())
+        .count();
 }
 
+InputManager::InputManager() = default;
+
 InputManager::~InputManager() {
     stop();
 }
 
+void InputManager::setRealtimeConfig(const RealtimeConfig& config) {
+    realtimeConfig = config;
+}
+
+void InputManager::setReceiveBufferSize(int bytes) {
+    receiveBufferBytes = bytes;
+}
+
+void InputManager::setOnChange(std::function<void()> callback) {
+    onChange = std::move(callback);
+}
+
 void InputManager::start(const char* joystickPath) {
     running.store(true);
     
@@ -49,83 +70,375 @@ void InputManager::start(const char* joystickPath) {
         freeifaddrs(ifaddr);
     }
 
-    std::string path = joystickPath ? joystickPath : Constants::DEFAULT_JOYSTICK_PATH;
-    
-    joystickThread = std::thread(&InputManager::joystickWorker, this, path);
-    udpThread = std::thread(&InputManager::udpWorker, this);
+    this->joystickPath = joystickPath ? joystickPath : Constants::DEFAULT_JOYSTICK_PATH;
+
+    wakeFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (wakeFd < 0) {
+        perror("eventfd failed");
+        running.store(false);
+        return;
+    }
+    inputThread = std::thread(&InputManager::eventLoop, this);
 }
 
 void InputManager::stop() {
     running.store(false);
-    if (joystickThread.joinable()) joystickThread.join();
-    if (udpThread.joinable()) udpThread.join();
+    wakeLoop();
+    if (inputThread.joinable()) inputThread.join();
+    if (wakeFd >= 0) {
+        close(wakeFd);
+        wakeFd = -1;
+    }
 }
 
 int16_t InputManager::getAxis(int axis) {
     if (axis >= 0 && axis < 8) {
-        return axes[axis].load(std::memory_order_relaxed);
+        return arbiter.snapshot().axes[axis];
     }
     return 0;
 }
 
-int InputManager::openJoystick(const char* path) {
-    int fd = open(path, O_RDONLY | O_NONBLOCK);
-    if (fd < 0) {
-        // Only log error if we really expected it, or just once. 
-        // For now, we can log to stderr.
-        // std::cerr << "Failed to open joystick at " << path << ": " << std::strerror(errno) << '\n';
+void InputManager::setAutopilot(const InputState& state) {
+    arbiter.setAutopilot(state);
+    wakeLoop();
+}
+
+void InputManager::clearAutopilot() {
+    arbiter.clearAutopilot();
+    wakeLoop();
+}
+
+// The event loop reports the change through onChange
+void InputManager::wakeLoop() {
+    if (wakeFd >= 0) {
+        const uint64_t one = 1;
+        (void)!write(wakeFd, &one, sizeof(one));
     }
-    return fd;
 }
 
-void InputManager::joystickWorker(std::string path) {
-    int fd = -1;
-    
-    while (running.load(std::memory_order_relaxed)) {
-        if (fd < 0) {
-            fd = openJoystick(path.c_str());
-            if (fd < 0) {
-                // Retry every second if not found
-                std::this_thread::sleep_for(std::chrono::seconds(1));
-                continue;
+LinkStats InputManager::linkStats() const {
+    const InputSnapshot snap = arbiter.snapshot();
+    const unsigned client = snap.source == InputSource::Udp
+        ? snap.client : lastClient.load(std::memory_order_relaxed);
+    return clients[client].link.snapshot();
+}
+
+// ─── UDP clients ────────────────────────────────────────────────────────────
+
+int InputManager::clientFor(const sockaddr_in& sender, uint64_t nowMs) {
+    int victim = -1;
+    for (unsigned i = 0; i < clients.size(); ++i) {
+        const UdpClient& c = clients[i];
+        if (c.used && c.address == sender.sin_addr.s_addr && c.port == sender.sin_port) {
+            return static_cast<int>(i);
+        }
+        // Free slots first, then the longest-silent expired one
+        if (!c.used) {
+            if (victim < 0 || clients[victim].used) victim = static_cast<int>(i);
+        } else if (nowMs - c.lastMs >= Constants::UDP_WATCHDOG_MS &&
+                   (victim < 0 || (clients[victim].used && c.lastMs < clients[victim].lastMs))) {
+            victim = static_cast<int>(i);
+        }
+    }
+    if (victim < 0) return -1;
+
+    UdpClient& c = clients[victim];
+    if (c.used) {
+        arbiter.dropClient(static_cast<unsigned>(victim));
+        c.link.restart();
+    }
+    c.used = true;
+    c.address = sender.sin_addr.s_addr;
+    c.port = sender.sin_port;
+    c.lastMs = nowMs;
+    c.state = {};
+    return victim;
+}
+
+// Client y is up-positive; the joystick device convention is down-positive
+static int16_t invertAxis(int16_t value) {
+    return value == INT16_MIN ? INT16_MAX : static_cast<int16_t>(-value);
+}
+
+bool InputManager::applyPacket(const char* data, size_t length) {
+    ControlCommand command;
+    if (!decodePacket(data, length, command)) return false;
+    const uint64_t nowMs = currentMs();
+    const int client = clientFor(sockaddr_in{}, nowMs);
+    if (client < 0 || !sequencePacket(static_cast<unsigned>(client), command)) return false;
+    applyCommand(static_cast<unsigned>(client), command, nowMs);
+    return true;
+}
+
+bool InputManager::applyJsonPacket(const char* packet) {
+    return applyPacket(packet, std::strlen(packet));
+}
+
+bool InputManager::decodePacket(const char* data, size_t length, ControlCommand& command) {
+    ControlPacket packet;
+    switch (decodeControlPacket(reinterpret_cast<const uint8_t*>(data), length, packet)) {
+        case ControlPacketStatus::Ok:
+            command.sequenced = true;
+            command.sequence = packet.sequence;
+            command.hasTimestamp = packet.hasTimestamp;
+            command.sentUs = packet.sentUs;
+            command.hasLeft = command.hasRight = command.hasButtons = true;
+            command.x  = packet.leftX;
+            command.y  = invertAxis(packet.leftY);
+            command.rx = packet.rightX;
+            command.ry = invertAxis(packet.rightY);
+            command.buttons = packet.buttons;
+            return true;
+        case ControlPacketStatus::NotBinary:
+            return decodeJson(data, data + length, command);
+        default:
+            return false;
+    }
+}
+
+bool InputManager::decodeJson(const char* begin, const char* end, ControlCommand& command) {
+    try {
+        auto j = json::parse(begin, end);
+
+        // Optional sequencing, as in the binary format
+        if (j.contains("seq")) {
+            command.sequenced = true;
+            command.sequence = j["seq"].get<uint32_t>();
+            command.hasTimestamp = j.contains("t_us");
+            command.sentUs = command.hasTimestamp ? j["t_us"].get<uint32_t>() : 0;
+        }
+        if (j.contains("joysticks")) {
+            auto& joy = j["joysticks"];
+
+            if (joy.contains("left") && joy["left"].is_array()) {
+                float x = joy["left"][0];
+                float y = joy["left"][1];
+                command.hasLeft = true;
+                command.x = static_cast<int16_t>(x * Constants::MAX_JOYSTICK_VALUE);
+                command.y = static_cast<int16_t>(-y * Constants::MAX_JOYSTICK_VALUE);
+            }
+            if (joy.contains("right") && joy["right"].is_array()) {
+                float x = joy["right"][0];
+                float y = joy["right"][1];
+                command.hasRight = true;
+                command.rx = static_cast<int16_t>(x * Constants::MAX_JOYSTICK_VALUE);
+                command.ry = static_cast<int16_t>(-y * Constants::MAX_JOYSTICK_VALUE);
             }
-            std::cout << "Joystick connected at " << path << std::endl;
         }
+        return true;
+    } catch (const std::exception& e) {
+        std::cerr << "JSON parse error: " << e.what() << '\n';
+        return false;
+    }
+}
+
+// Order and age a decoded packet against its sender's earlier ones
+bool InputManager::sequencePacket(unsigned client, const ControlCommand& command) {
+    if (!command.sequenced) return true;
+    return clients[client].link.onPacket(command.sequence, command.hasTimestamp, command.sentUs, currentUs())
+           == LinkQuality::Verdict::Accept;
+}
+
+void InputManager::applyCommand(unsigned client, const ControlCommand& command, uint64_t nowMs) {
+    // JSON packets may update only some fields; the rest keep their values
+    InputState& state = clients[client].state;
+    if (command.hasLeft) {
+        state.axes[Constants::JOYSTICK_AXIS_X] = command.x;
+        state.axes[Constants::JOYSTICK_AXIS_Y] = command.y;
+    }
+    if (command.hasRight) {
+        state.axes[Constants::JOYSTICK_AXIS_RX] = command.rx;
+        state.axes[Constants::JOYSTICK_AXIS_RY] = command.ry;
+    }
+    if (command.hasButtons) {
+        state.buttons = command.buttons;
+    }
+    clients[client].lastMs = nowMs;
+    lastClient.store(static_cast<uint8_t>(client), std::memory_order_relaxed);
+    arbiter.setClient(client, state, nowMs);
+}
+
+int InputManager::openJoystick(const char* path) {
+    return open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+}
+
+// ─── Event loop ─────────────────────────────────────────────────────────────
+//
+//  One thread, one epoll set: the UDP socket, the joystick, a timerfd for
+//  the network watchdog, inotify on the joystick's directory for hotplug
+//  and an eventfd that stop() uses to wake the loop.  Nothing polls: the
+//  thread sleeps in epoll_wait() until one of them is ready.
+//
+
+static bool watchFd(int epollFd, int fd) {
+    epoll_event ev{};
+    ev.events = EPOLLIN;
+    ev.data.fd = fd;
+    return epoll_ctl(epollFd, EPOLL_CTL_ADD, fd, &ev) == 0;
+}
+
+static void armTimer(int timerFd, uint64_t delayMs, uint64_t intervalMs = 0) {
+    itimerspec spec{};
+    spec.it_value.tv_sec = static_cast<time_t>(delayMs / 1000);
+    spec.it_value.tv_nsec = static_cast<long>((delayMs % 1000) * 1'000'000);
+    spec.it_interval.tv_sec = static_cast<time_t>(intervalMs / 1000);
+    spec.it_interval.tv_nsec = static_cast<long>((intervalMs % 1000) * 1'000'000);
+    timerfd_settime(timerFd, 0, &spec, nullptr);
+}
+
+void InputManager::eventLoop() {
+    RealTime::configureCurrentThread(realtimeConfig, "input");
+
+    epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (epollFd < 0) {
+        perror("epoll_create1 failed");
+        return;
+    }
+    watchFd(epollFd, wakeFd);
+
+    udpFd = openUdpSocket();
+    if (udpFd >= 0) watchFd(epollFd, udpFd);
+
+    watchdogFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    if (watchdogFd >= 0) watchFd(epollFd, watchdogFd);
+
+    // Hotplug: the joystick node appears in its directory (IN_CREATE) and
+    // udev then fixes its permissions (IN_ATTRIB).  Without inotify, fall
+    // back to retrying once a second.
+    const size_t slash = joystickPath.rfind('/');
+    const std::string directory = slash == std::string::npos ? "."
+                                : slash == 0 ? "/" : joystickPath.substr(0, slash);
+    joystickName = slash == std::string::npos ? joystickPath : joystickPath.substr(slash + 1);
+    hotplugFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (hotplugFd >= 0 &&
+        inotify_add_watch(hotplugFd, directory.c_str(), IN_CREATE | IN_ATTRIB | IN_MOVED_TO) >= 0) {
+        watchFd(epollFd, hotplugFd);
+    } else {
+        std::cerr << "Joystick hotplug unavailable for " << directory << ": "
+                  << std::strerror(errno) << " - retrying every second\n";
+        if (hotplugFd >= 0) close(hotplugFd);
+        hotplugFd = -1;
+        retryFd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (retryFd >= 0) {
+            armTimer(retryFd, 1000, 1000);
+            watchFd(epollFd, retryFd);
+        }
+    }
+
+    connectJoystick();
 
-        js_event event;
-        ssize_t bytes = read(fd, &event, sizeof(event));
-        while (bytes == sizeof(event)) {
-            event.type &= ~JS_EVENT_INIT;
-            if (event.type == JS_EVENT_AXIS && event.number < 8) {
-                axes[event.number].store(event.value, std::memory_order_relaxed);
+    epoll_event events[8];
+    while (running.load(std::memory_order_relaxed)) {
+        const int n = epoll_wait(epollFd, events, 8, -1);
+        if (n < 0) {
+            if (errno == EINTR) continue;
+            perror("epoll_wait failed");
+            break;
+        }
+        for (int i = 0; i < n; ++i) {
+            const int fd = events[i].data.fd;
+            uint64_t count;
+            if (fd == udpFd) {
+                drainUdp();
+            } else if (fd == joystickFd) {
+                readJoystick(events[i].events);
+            } else if (fd == watchdogFd) {
+                if (read(watchdogFd, &count, sizeof(count)) == sizeof(count)) onWatchdog();
+            } else if (fd == hotplugFd) {
+                onHotplug();
+            } else if (fd == retryFd) {
+                if (read(retryFd, &count, sizeof(count)) == sizeof(count)) connectJoystick();
+            } else if (fd == wakeFd) {
+                // stop() (the loop condition handles it) or an autopilot update
+                if (read(wakeFd, &count, sizeof(count)) == sizeof(count) && onChange) onChange();
             }
-            bytes = read(fd, &event, sizeof(event));
         }
+    }
 
-        if (bytes < 0 && errno != EAGAIN) {
-            std::cerr << "Joystick read error: " << std::strerror(errno) << '\n';
-            close(fd);
-            fd = -1;
+    disconnectJoystick();
+    for (int* fd : {&udpFd, &watchdogFd, &hotplugFd, &retryFd, &epollFd}) {
+        if (*fd >= 0) close(*fd);
+        *fd = -1;
+    }
+}
+
+// ─── Joystick ───────────────────────────────────────────────────────────────
+
+void InputManager::connectJoystick() {
+    if (joystickFd >= 0) return;
+    joystickFd = openJoystick(joystickPath.c_str());
+    if (joystickFd < 0) return;
+    if (!watchFd(epollFd, joystickFd)) {
+        perror("epoll_ctl joystick failed");
+        close(joystickFd);
+        joystickFd = -1;
+        return;
+    }
+    std::cout << "Joystick connected at " << joystickPath << std::endl;
+}
+
+void InputManager::disconnectJoystick() {
+    if (joystickFd < 0) return;
+    epoll_ctl(epollFd, EPOLL_CTL_DEL, joystickFd, nullptr);
+    close(joystickFd);
+    joystickFd = -1;
+
+    // The stick no longer counts; the driver replays its position on reopen
+    joystickState = {};
+}
+
+void InputManager::readJoystick(uint32_t ready) {
+    js_event events[16];
+    ssize_t bytes;
+    bool changed = false;
+    while ((bytes = read(joystickFd, events, sizeof(events))) > 0) {
+        for (size_t i = 0; i < static_cast<size_t>(bytes) / sizeof(js_event); ++i) {
+            const uint8_t type = events[i].type & ~JS_EVENT_INIT;
+            if (type == JS_EVENT_AXIS && events[i].number < 8) {
+                joystickState.axes[events[i].number] = events[i].value;
+                changed = true;
+            }
         }
-        
-        std::this_thread::sleep_for(std::chrono::milliseconds(10));
     }
 
-    if (fd >= 0) close(fd);
+    if ((bytes < 0 && errno != EAGAIN) || bytes == 0 || (ready & (EPOLLERR | EPOLLHUP))) {
+        std::cerr << "Joystick disconnected: "
+                  << (bytes < 0 ? std::strerror(errno) : "hang-up") << '\n';
+        disconnectJoystick();
+        changed = true;
+    }
+    if (changed) {
+        arbiter.setJoystick(joystickState, joystickFd >= 0);
+        if (onChange) onChange();
+    }
 }
 
-void InputManager::udpWorker() {
+void InputManager::onHotplug() {
+    alignas(inotify_event) char buffer[4096];
+    ssize_t bytes;
+    bool ours = false;
+    while ((bytes = read(hotplugFd, buffer, sizeof(buffer))) > 0) {
+        for (ssize_t offset = 0; offset < bytes;) {
+            const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+            if (event->len > 0 && joystickName == event->name) ours = true;
+            offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+        }
+    }
+    if (ours) connectJoystick();
+}
+
+// ─── UDP ────────────────────────────────────────────────────────────────────
+
+int InputManager::openUdpSocket() {
     int sockfd;
-    char buffer[Constants::UDP_BUFFER_SIZE];
-    struct sockaddr_in servaddr, cliaddr;
+    struct sockaddr_in servaddr;
 
-    if ((sockfd = socket(AF_INET, SOCK_DGRAM, 0)) < 0) {
+    if ((sockfd = socket(AF_INET, SOCK_DGRAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)) < 0) {
         perror("socket creation failed");
-        return;
+        return -1;
     }
 
     memset(&servaddr, 0, sizeof(servaddr));
-    memset(&cliaddr, 0, sizeof(cliaddr));
 
     servaddr.sin_family = AF_INET;
     servaddr.sin_addr.s_addr = INADDR_ANY;
@@ -134,78 +447,123 @@ void InputManager::udpWorker() {
     if (bind(sockfd, (const struct sockaddr *)&servaddr, sizeof(servaddr)) < 0) {
         perror("bind failed");
         close(sockfd);
-        return;
+        return -1;
     }
 
-    struct timeval tv;
-    tv.tv_sec = 0;
-    tv.tv_usec = 100000; // 100ms timeout
-    setsockopt(sockfd, SOL_SOCKET, SO_RCVTIMEO, (const char*)&tv, sizeof tv);
+    if (receiveBufferBytes > 0 &&
+        setsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &receiveBufferBytes, sizeof(receiveBufferBytes)) < 0) {
+        perror("SO_RCVBUF failed");
+    }
+    int effectiveBuffer = 0;
+    socklen_t optLen = sizeof(effectiveBuffer);
+    getsockopt(sockfd, SOL_SOCKET, SO_RCVBUF, &effectiveBuffer, &optLen);
 
-    std::cout << "UDP Listener started on port " << Constants::UDP_PORT << std::endl;
+    std::cout << "UDP Listener started on port " << Constants::UDP_PORT
+              << " (receive buffer " << effectiveBuffer << " bytes)" << std::endl;
     std::cout << "Waiting for UDP packets..." << std::endl;
 
-    char lastClientIp[INET_ADDRSTRLEN] = {0};
-    int packetCount = 0;
-
-    while (running.load(std::memory_order_relaxed)) {
-        socklen_t len = sizeof(cliaddr);
-        int n = recvfrom(sockfd, (char *)buffer, Constants::UDP_BUFFER_SIZE,
-                    MSG_WAITALL, (struct sockaddr *) &cliaddr, &len);
-
-        uint64_t now = currentMs();
+    // One batch of receive slots, allocated once
+    udpStorage.assign(Constants::UDP_BATCH_SIZE * Constants::UDP_BUFFER_SIZE, 0);
+    udpMessages.resize(Constants::UDP_BATCH_SIZE);
+    udpVectors.resize(Constants::UDP_BATCH_SIZE);
+    udpSenders.resize(Constants::UDP_BATCH_SIZE);
+    return sockfd;
+}
 
+void InputManager::drainUdp() {
+    // Take full batches until the socket is empty; level-triggered epoll
+    // reports anything that arrives afterwards
+    constexpr unsigned BATCH = Constants::UDP_BATCH_SIZE;
+    bool applied = false;
+    int n;
+    do {
+        for (unsigned i = 0; i < BATCH; ++i) {
+            udpVectors[i] = {udpStorage.data() + i * Constants::UDP_BUFFER_SIZE, Constants::UDP_BUFFER_SIZE};
+            udpMessages[i].msg_hdr = {};
+            udpMessages[i].msg_hdr.msg_name = &udpSenders[i];
+            udpMessages[i].msg_hdr.msg_namelen = sizeof(sockaddr_in);
+            udpMessages[i].msg_hdr.msg_iov = &udpVectors[i];
+            udpMessages[i].msg_hdr.msg_iovlen = 1;
+        }
+        n = recvmmsg(udpFd, udpMessages.data(), BATCH, MSG_DONTWAIT, nullptr);
         if (n > 0) {
+            const sockaddr_in* client = applyNewestPerSender(udpMessages.data(), static_cast<unsigned>(n));
+
             // Log new client connections
-            char clientIp[INET_ADDRSTRLEN];
-            inet_ntop(AF_INET, &cliaddr.sin_addr, clientIp, INET_ADDRSTRLEN);
-            if (strcmp(clientIp, lastClientIp) != 0) {
-                std::cout << ">>> New UDP client connected: " << clientIp 
-                          << ":" << ntohs(cliaddr.sin_port) << std::endl;
-                strncpy(lastClientIp, clientIp, INET_ADDRSTRLEN);
+            if (client) {
+                applied = true;
+                char clientIp[INET_ADDRSTRLEN];
+                inet_ntop(AF_INET, &client->sin_addr, clientIp, INET_ADDRSTRLEN);
+                if (strcmp(clientIp, lastClientIp) != 0) {
+                    std::cout << ">>> New UDP client connected: " << clientIp
+                              << ":" << ntohs(client->sin_port) << std::endl;
+                    strncpy(lastClientIp, clientIp, INET_ADDRSTRLEN);
+                }
             }
+        }
+    } while (n == static_cast<int>(BATCH));
 
-            packetCount++;
-            lastNetworkUpdateMs = now;
-            networkActive = true;
+    // Watchdog: a client loses control once it has been silent this long.
+    // Armed on the first packet; onWatchdog() re-arms it for the next client
+    // due to expire.
+    if (applied && !watchdogArmed && watchdogFd >= 0) {
+        armTimer(watchdogFd, Constants::UDP_WATCHDOG_MS);
+        watchdogArmed = true;
+    }
+    if (applied && onChange) onChange();
+}
 
-            buffer[n] = '\0';
-            
-            // Debug: print raw packet data every 20 packets
-            if (packetCount % 20 == 1) {
-                std::cout << "[UDP #" << packetCount << "] Raw (" << n << " bytes): " << buffer << std::endl;
-            }
+void InputManager::onWatchdog() {
+    uint64_t nextMs = 0;
+    const unsigned released = arbiter.expire(currentMs(), nextMs);
+    if (released > 0) {
+        std::cout << "Network timeout - released " << released << " UDP client(s)" << std::endl;
+    }
+    watchdogArmed = nextMs > 0;
+    if (watchdogArmed) armTimer(watchdogFd, nextMs);
+    if (released > 0 && onChange) onChange();
+}
 
-            try {
-                auto j = json::parse(buffer);
-                if (j.contains("joysticks")) {
-                    auto& joy = j["joysticks"];
-                    
-                    if (joy.contains("left") && joy["left"].is_array()) {
-                        float x = joy["left"][0];
-                        float y = joy["left"][1];
-                        axes[Constants::JOYSTICK_AXIS_X].store(static_cast<int16_t>(x * Constants::MAX_JOYSTICK_VALUE));
-                        axes[Constants::JOYSTICK_AXIS_Y].store(static_cast<int16_t>(-y * Constants::MAX_JOYSTICK_VALUE));
-                    }
-                    if (joy.contains("right") && joy["right"].is_array()) {
-                        float x = joy["right"][0];
-                        float y = joy["right"][1];
-                        axes[Constants::JOYSTICK_AXIS_RX].store(static_cast<int16_t>(x * Constants::MAX_JOYSTICK_VALUE));
-                        axes[Constants::JOYSTICK_AXIS_RY].store(static_cast<int16_t>(-y * Constants::MAX_JOYSTICK_VALUE));
-                    }
-                }
-            } catch (const std::exception& e) {
-                std::cerr << "JSON parse error: " << e.what() << '\n';
-            }
-        }
+const sockaddr_in* InputManager::applyNewestPerSender(mmsghdr* messages, unsigned count) {
+    // Latest wins: every valid datagram is sequenced in arrival order (so
+    // loss and delay statistics see all of them), but only the newest
+    // accepted command of each sender is applied.  Senders are told apart
+    // by address and port; a client slot is only claimed once a datagram
+    // has decoded, and live slots are never reassigned, so a slot keeps
+    // its sender for the whole batch.
+    struct Latest {
+        const sockaddr_in* sender;
+        unsigned client;
+        ControlCommand command;
+    };
+    Latest latest[Constants::UDP_BATCH_SIZE];
+    unsigned senderCount = 0;
+    const uint64_t nowMs = currentMs();
 
-        if (networkActive && (now - lastNetworkUpdateMs > 1000)) {
-            std::cout << "Network timeout - resetting inputs" << std::endl;
-            networkActive = false;
-            for (int i = 0; i < 8; ++i) {
-                axes[i].store(0);
-            }
+    for (unsigned i = 0; i < count; ++i) {
+        ControlCommand command;
+        const auto* data = static_cast<const char*>(messages[i].msg_hdr.msg_iov->iov_base);
+        if (!decodePacket(data, messages[i].msg_len, command)) continue;
+
+        const auto* sender = static_cast<const sockaddr_in*>(messages[i].msg_hdr.msg_name);
+        const int client = clientFor(*sender, nowMs);
+        if (client < 0 || !sequencePacket(static_cast<unsigned>(client), command)) continue;
+
+        unsigned k = 0;
+        while (k < senderCount && !(latest[k].sender->sin_addr.s_addr == sender->sin_addr.s_addr &&
+                                    latest[k].sender->sin_port == sender->sin_port)) {
+            ++k;
         }
+        if (k == senderCount) {
+            ++senderCount;
+        } else {
+            coalesced.fetch_add(1, std::memory_order_relaxed);
+        }
+        latest[k] = {sender, static_cast<unsigned>(client), command};
+    }
+
+    for (unsigned k = 0; k < senderCount; ++k) {
+        applyCommand(latest[k].client, latest[k].command, nowMs);
     }
-    close(sockfd);
+    return senderCount > 0 ? latest[senderCount - 1].sender : nullptr;
 }
@@ -1,27 +1,149 @@
 #pragma once
+#include <array>
 #include <atomic>
+#include <functional>
+#include <string>
 #include <thread>
+#include <vector>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+#include <sys/socket.h>
 #include "Constants.hpp"
+#include "InputArbiter.hpp"
+#include "LinkQuality.hpp"
+#include "RealTime.hpp"
 
 class InputManager {
 public:
     InputManager();
     ~InputManager();
 
+    /// Scheduling policy for the input thread (joystick and UDP).  Must be
+    /// called before start().
+    void setRealtimeConfig(const RealtimeConfig& config);
+
+    /// SO_RCVBUF for the UDP socket, in bytes (0 = kernel default).  Must
+    /// be called before start().
+    void setReceiveBufferSize(int bytes);
+
+    /// Called on the input thread right after the arbitrated input may have
+    /// changed: once per joystick read, once per UDP receive batch, when the
+    /// network watchdog releases a client and after an autopilot update.
+    /// Must be set before start(); runs inline with input handling, so keep
+    /// it short and non-blocking.
+    void setOnChange(std::function<void()> callback);
+
     void start(const char* joystickPath = nullptr);
     void stop();
+    /// All axes, buttons and the source they came from, taken together
+    /// from one update.  Lock-free and allocation-free; read this once per
+    /// control step rather than calling getAxis() per axis, which may mix
+    /// axes from consecutive packets.
+    InputSnapshot snapshot() const { return arbiter.snapshot(); }
+
     int16_t getAxis(int axis);
+    uint32_t getButtons() const { return arbiter.snapshot().buttons; }
+
+    /// Which source currently drives the axes (see InputArbiter.hpp).
+    InputSource activeSource() const { return arbiter.snapshot().source; }
+
+    /// Scripted control at the lowest priority: used whenever neither the
+    /// joystick nor a UDP client is in control, until clearAutopilot().
+    /// Callable from any thread.
+    void setAutopilot(const InputState& state);
+    void clearAutopilot();
+
+    /// Decode one UDP datagram, as the input thread does: the binary format
+    /// (ControlPacket.hpp) first, JSON as the fallback.  Sequenced packets
+    /// that are older than the newest one seen, or stale, are dropped.  The
+    /// datagram is attributed to a sender with no address.  Returns false
+    /// if the packet was rejected.
+    bool applyPacket(const char* data, size_t length);
+
+    /// Loss, delay and jitter of the UDP client in control (or, when none
+    /// is, of the one heard last).
+    LinkStats linkStats() const;
+
+    /// Datagrams skipped because a newer one from the same sender arrived
+    /// in the same receive batch.
+    uint64_t coalescedPackets() const { return coalesced.load(std::memory_order_relaxed); }
+
+    /// Decode one NUL-terminated JSON control packet into the axes.
+    /// Returns false on a parse error.
+    bool applyJsonPacket(const char* packet);
 
 private:
-    std::atomic<int16_t> axes[8];
+    InputArbiter arbiter;
+
+    // Per-sender state, owned by the input thread (link stats excepted).
+    // Senders are told apart by address and port.  A slot is only handed
+    // out for a valid datagram, and only a slot silent for UDP_WATCHDOG_MS
+    // is ever reused; while all are live, new senders are ignored.
+    struct UdpClient {
+        bool used = false;
+        in_addr_t address = 0;
+        in_port_t port = 0;
+        uint64_t lastMs = 0;
+        LinkQuality link;
+        InputState state;
+    };
+    std::array<UdpClient, Constants::UDP_MAX_CLIENTS> clients;
+    std::atomic<uint8_t> lastClient{0};
+    std::atomic<uint64_t> coalesced{0};
+
+    InputState joystickState;               // input thread only
+    int receiveBufferBytes = Constants::UDP_RECEIVE_BUFFER_BYTES;
     std::atomic<bool> running{false};
-    std::thread joystickThread;
-    std::thread udpThread;
+    std::thread inputThread;
+    RealtimeConfig realtimeConfig;
+    std::function<void()> onChange;
+
+    // Event loop descriptors; all but wakeFd are owned by the input thread
+    int wakeFd = -1;
+    int epollFd = -1;
+    int udpFd = -1;
+    int joystickFd = -1;
+    int watchdogFd = -1;
+    int hotplugFd = -1;
+    int retryFd = -1;
+    bool watchdogArmed = false;
+    std::string joystickPath;
+    std::string joystickName;
 
-    uint64_t lastNetworkUpdateMs{0};
-    bool networkActive{false};
+    // UDP receive batch, allocated once
+    std::vector<char> udpStorage;
+    std::vector<mmsghdr> udpMessages;
+    std::vector<iovec> udpVectors;
+    std::vector<sockaddr_in> udpSenders;
+    char lastClientIp[INET_ADDRSTRLEN] = {0};
 
-    void joystickWorker(std::string path);
-    void udpWorker();
+    void eventLoop();
+    int openUdpSocket();
+    void drainUdp();
     int openJoystick(const char* path);
+    void connectJoystick();
+    void disconnectJoystick();
+    void readJoystick(uint32_t ready);
+    void onHotplug();
+    // One decoded control datagram; JSON packets may carry only some fields
+    struct ControlCommand {
+        bool hasLeft = false;
+        bool hasRight = false;
+        bool hasButtons = false;
+        int16_t x = 0, y = 0, rx = 0, ry = 0;
+        uint32_t buttons = 0;
+        bool sequenced = false;             // JSON "seq" is optional
+        bool hasTimestamp = false;
+        uint32_t sequence = 0;
+        uint32_t sentUs = 0;
+    };
+
+    int clientFor(const sockaddr_in& sender, uint64_t nowMs);
+    bool decodePacket(const char* data, size_t length, ControlCommand& command);
+    bool decodeJson(const char* begin, const char* end, ControlCommand& command);
+    bool sequencePacket(unsigned client, const ControlCommand& command);
+    void applyCommand(unsigned client, const ControlCommand& command, uint64_t nowMs);
+    void onWatchdog();
+    void wakeLoop();
+    const sockaddr_in* applyNewestPerSender(mmsghdr* messages, unsigned count);
 };
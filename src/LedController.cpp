@@ -1,49 +1,217 @@
 #include "LedController.hpp"
+#include "RealTime.hpp"
+#include <bit>
+#include <chrono>
+#include <cmath>
 #include <cstring>
 #include <fcntl.h>
+#include <fstream>
 #include <iostream>
 #include <linux/spi/spidev.h>
+#include <sstream>
 #include <sys/ioctl.h>
 #include <unistd.h>
 #include <algorithm>
 
-// ─── Face-segment table ─────────────────────────────────────────────────────
-//
-//  TODO: populate once the physical LED layout on the face is finalised.
-//        Each entry maps a logical name → (start pixel, pixel count).
-//        The sum of all segments need not cover the full strip; gaps are fine.
-//
-//  Example (uncomment / edit when ready):
-//
-//    { "left_eye",   0,  12 },
-//    { "right_eye", 20,  12 },
-//    { "mouth",     40,  30 },
-//
-static const std::vector<LedSegment> kFaceSegments = {
-    // ── placeholder ── fill in when wiring map is known ──
-};
-
 // ─── WS2815 NRZ timing via SPI ──────────────────────────────────────────────
 //
 //  The WS2815 uses the same 800 kHz NRZ protocol as WS2812B.
-//  Each data bit is encoded as a multi-bit SPI pattern at ~6.4 MHz:
+//  Each data bit is encoded as a multi-bit SPI pattern; two encodings:
 //
+//  8-bit (default), LED_SPI_SPEED_HZ = 6.4 MHz, 156.25 ns per SPI bit:
 //    Bit 1 → 0b11110000  (high ≈ 0.625 µs, low ≈ 0.625 µs)
 //    Bit 0 → 0b11000000  (high ≈ 0.3125 µs, low ≈ 0.9375 µs)
+//    → 8 bytes per colour byte, 24 bytes per pixel.
+//
+//  3-bit, LED_SPI3_SPEED_HZ = 2.7 MHz, ≈ 370 ns per SPI bit:
+//    Bit 1 → 0b110       (high ≈ 0.741 µs, low ≈ 0.370 µs)
+//    Bit 0 → 0b100       (high ≈ 0.370 µs, low ≈ 0.741 µs)
+//    → 3 bytes per colour byte, 9 bytes per pixel.
 //
 //  After all pixel data, ≥280 µs of low (reset code) is required.
-//  We achieve this with SPI_SPEED_HZ = 6'400'000 and sending 8 SPI bits
-//  per WS2815 data bit → 8 bytes per colour byte, 24 bytes per pixel.
 //
 static constexpr uint8_t BIT_ONE  = 0b11110000;
 static constexpr uint8_t BIT_ZERO = 0b11000000;
-static constexpr size_t  RESET_BYTES = 32;         // ≥280 µs of zeros at 6.4 MHz
+static constexpr size_t  RESET_BYTES = 224;        // ≥280 µs of zeros at 6.4 MHz
+static constexpr size_t  SPI_BYTES_PER_CHANNEL = 8;
+
+static constexpr uint8_t BIT3_ONE  = 0b110;
+static constexpr uint8_t BIT3_ZERO = 0b100;
+static constexpr size_t  RESET3_BYTES = 96;        // ≥280 µs of zeros at 2.7 MHz
+static constexpr size_t  SPI3_BYTES_PER_CHANNEL = 3;
+
+// ─── Colour byte → SPI pattern tables ──────────────────────────────────────
+//
+//  All 256 colour values pre-encoded, packed so that one little-endian
+//  store emits them MSB-first: 8 bytes for the 8-bit encoding, and the 3
+//  significant bytes of a 4-byte store for the 3-bit one (the spare byte
+//  is overwritten by the next channel or the reset code).
+//
+static_assert(std::endian::native == std::endian::little,
+              "NRZ patterns are packed for little-endian stores");
+
+static constexpr std::array<uint64_t, 256> makeNrzPatterns() {
+    std::array<uint64_t, 256> table{};
+    for (unsigned value = 0; value < 256; ++value) {
+        uint64_t pattern = 0;
+        for (unsigned slot = 0; slot < 8; ++slot) {
+            const bool one = value & (0x80u >> slot);
+            pattern |= static_cast<uint64_t>(one ? BIT_ONE : BIT_ZERO) << (slot * 8);
+        }
+        table[value] = pattern;
+    }
+    return table;
+}
+
+static constexpr std::array<uint32_t, 256> makeNrz3Patterns() {
+    std::array<uint32_t, 256> table{};
+    for (unsigned value = 0; value < 256; ++value) {
+        // 24-bit SPI stream, first bit in bit 23
+        uint32_t stream = 0;
+        for (unsigned slot = 0; slot < 8; ++slot) {
+            const bool one = value & (0x80u >> slot);
+            stream = (stream << 3) | (one ? BIT3_ONE : BIT3_ZERO);
+        }
+        table[value] = ((stream >> 16) & 0xFF) | (stream & 0xFF00) | ((stream & 0xFF) << 16);
+    }
+    return table;
+}
+
+static constexpr std::array<uint64_t, 256> kNrzPatterns = makeNrzPatterns();
+static constexpr std::array<uint32_t, 256> kNrz3Patterns = makeNrz3Patterns();
+
+// ─── Encoder verification (compile time) ────────────────────────────────────
+//
+//  Every table entry is decoded back from the SPI bytes it emits, and each
+//  encoding's high/low times are checked against the WS2815 datasheet:
+//  T0H 220–380 ns, T1H 580–1000 ns, and either low phase ≥ 220 ns (the
+//  receiver resamples on the next rising edge, so only the reset threshold
+//  bounds it from above).
+//
+struct NrzCell {
+    unsigned bits;      // SPI bits per NRZ bit
+    unsigned highZero;  // leading ones in a 0 cell
+    unsigned highOne;   // leading ones in a 1 cell
+    uint32_t speedHz;
+};
+
+static constexpr bool meetsDatasheet(const NrzCell& cell) {
+    const double bitNs = 1e9 / cell.speedHz;
+    const double t0h = cell.highZero * bitNs;
+    const double t1h = cell.highOne * bitNs;
+    const double t0l = (cell.bits - cell.highZero) * bitNs;
+    const double t1l = (cell.bits - cell.highOne) * bitNs;
+    return t0h >= 220 && t0h <= 380 && t1h >= 580 && t1h <= 1000 && t0l >= 220 && t1l >= 220;
+}
+
+/// Decode one colour byte from its emitted SPI bytes, or -1 on a bad cell.
+static constexpr int decodeNrz(const uint8_t* bytes, const NrzCell& cell) {
+    int value = 0;
+    for (unsigned nrz = 0; nrz < 8; ++nrz) {
+        unsigned high = 0;
+        bool falling = false;
+        for (unsigned i = 0; i < cell.bits; ++i) {
+            const unsigned bit = nrz * cell.bits + i;
+            const bool level = (bytes[bit / 8] >> (7 - bit % 8)) & 1;
+            if (level && falling) return -1;            // must be one high pulse
+            if (level) ++high; else falling = true;
+        }
+        if (high != cell.highZero && high != cell.highOne) return -1;
+        value = (value << 1) | (high == cell.highOne);
+    }
+    return value;
+}
+
+static constexpr bool verifyNrzPatterns() {
+    constexpr NrzCell cell8{8, 2, 4, Constants::LED_SPI_SPEED_HZ};
+    constexpr NrzCell cell3{3, 1, 2, Constants::LED_SPI3_SPEED_HZ};
+    for (unsigned value = 0; value < 256; ++value) {
+        uint8_t bytes8[8]{};
+        uint8_t bytes3[4]{};
+        for (unsigned i = 0; i < 8; ++i) bytes8[i] = static_cast<uint8_t>(kNrzPatterns[value] >> (8 * i));
+        for (unsigned i = 0; i < 4; ++i) bytes3[i] = static_cast<uint8_t>(kNrz3Patterns[value] >> (8 * i));
+        if (decodeNrz(bytes8, cell8) != static_cast<int>(value)) return false;
+        if (decodeNrz(bytes3, cell3) != static_cast<int>(value)) return false;
+    }
+    return meetsDatasheet(cell8) && meetsDatasheet(cell3);
+}
+
+static_assert(verifyNrzPatterns(), "NRZ pattern tables violate the WS2815 encoding");
+static_assert(RESET_BYTES * 8 * 1e6 / Constants::LED_SPI_SPEED_HZ >= 280, "8-bit reset too short");
+static_assert(RESET3_BYTES * 8 * 1e6 / Constants::LED_SPI3_SPEED_HZ >= 280, "3-bit reset too short");
+
+// ─── Ordered dither ─────────────────────────────────────────────────────────
+//
+//  Thresholds for one dither cycle, in 8.8 fraction units, visited in
+//  bit-reversed order so the on-frames of a channel are spread evenly over
+//  the cycle.  Each is centred in its 1/N slot: over a full cycle a level
+//  averages to its 8.8 value rounded to the nearest 1/N LSB.
+//
+static_assert((Constants::LED_DITHER_CYCLE_FRAMES & (Constants::LED_DITHER_CYCLE_FRAMES - 1)) == 0,
+              "dither cycle must be a power of two");
+
+static constexpr std::array<uint16_t, Constants::LED_DITHER_CYCLE_FRAMES> makeDitherThresholds() {
+    constexpr unsigned N = Constants::LED_DITHER_CYCLE_FRAMES;
+    std::array<uint16_t, N> table{};
+    for (unsigned step = 0; step < N; ++step) {
+        unsigned reversed = 0;
+        for (unsigned bit = 1, mirror = N >> 1; bit < N; bit <<= 1, mirror >>= 1) {
+            if (step & bit) reversed |= mirror;
+        }
+        table[step] = static_cast<uint16_t>((reversed * 256 + 128) / N);
+    }
+    return table;
+}
+
+static constexpr auto kDitherThresholds = makeDitherThresholds();
+
+// ─── Frame hash ─────────────────────────────────────────────────────────────
+//
+//  64-bit multiply-xorshift over a frame (encoded bytes or source pixels),
+//  one word at a time.  Only used to spot identical frames, so collisions
+//  merely cost a frame.
+//
+static uint64_t hashBytes(const uint8_t* data, size_t size) {
+    uint64_t h = 0x9E3779B97F4A7C15ull ^ size;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= size; i += sizeof(uint64_t)) {
+        uint64_t word;
+        std::memcpy(&word, data + i, sizeof(word));
+        h = (h ^ word) * 0xFF51AFD7ED558CCDull;
+        h ^= h >> 32;
+    }
+    for (; i < size; ++i) {
+        h = (h ^ data[i]) * 0xFF51AFD7ED558CCDull;
+    }
+    return h;
+}
+
+static uint64_t hashFrame(const std::vector<uint8_t>& frame) {
+    return hashBytes(frame.data(), frame.size());
+}
+
+static uint64_t hashFrame(const std::vector<Pixel>& frame) {
+    static_assert(sizeof(Pixel) == 3, "Pixel must be packed RGB");
+    return hashBytes(reinterpret_cast<const uint8_t*>(frame.data()), frame.size() * sizeof(Pixel));
+}
 
 // ─── Construction / destruction ─────────────────────────────────────────────
 
-LedController::LedController()
-    : pixels(Constants::LED_PIXEL_COUNT)
+LedController::LedController(const LedStripConfig& config)
+    : strip(config)
+    , pixels(config.pixelCount)
 {
+    refreshGammaLut();
+
+    // Pixel slots and SPI frames are sized once; neither show() nor the
+    // render thread ever allocates
+    for (auto& slot : frameSlots) {
+        slot.assign(pixels.size(), Pixel{});
+    }
+    composeBuffer.assign(pixels.size(), Pixel{});
+    for (auto& frame : spiFrames) {
+        frame.assign(frameBytes(), 0x00);
+    }
 }
 
 LedController::~LedController() {
@@ -53,23 +221,23 @@ LedController::~LedController() {
 // ─── Initialisation ─────────────────────────────────────────────────────────
 
 bool LedController::initialize() {
-    spiFd = open(Constants::LED_SPI_DEVICE, O_RDWR);
+    spiFd = open(strip.device.c_str(), O_RDWR);
     if (spiFd < 0) {
         std::cerr << "LED: failed to open SPI device "
-                  << Constants::LED_SPI_DEVICE << ": "
+                  << strip.device << ": "
                   << strerror(errno) << '\n';
         return false;
     }
 
     uint8_t  mode  = SPI_MODE_0;
     uint8_t  bits  = 8;
-    uint32_t speed = Constants::LED_SPI_SPEED_HZ;
+    uint32_t speed = spiSpeedHz();
 
     if (ioctl(spiFd, SPI_IOC_WR_MODE,          &mode)  < 0 ||
         ioctl(spiFd, SPI_IOC_WR_BITS_PER_WORD, &bits)  < 0 ||
         ioctl(spiFd, SPI_IOC_WR_MAX_SPEED_HZ,  &speed) < 0)
     {
-        std::cerr << "LED: SPI ioctl configuration failed\n";
+        std::cerr << "LED: SPI ioctl configuration failed on " << strip.device << '\n';
         close(spiFd);
         spiFd = -1;
         return false;
@@ -79,18 +247,22 @@ bool LedController::initialize() {
     clear();
     show();
 
-    std::cout << "LED: WS2815 strip ready ("
-              << Constants::LED_PIXEL_COUNT << " px on "
-              << Constants::LED_SPI_DEVICE  << " @ "
-              << Constants::LED_SPI_SPEED_HZ / 1000000.0 << " MHz)\n";
+    rendering = true;
+    renderThread = std::thread(&LedController::renderWorker, this);
 
-    if (kFaceSegments.empty()) {
-        std::cout << "LED: (no face segments defined yet – "
-                     "populate kFaceSegments when layout is finalised)\n";
+    std::cout << "LED: WS2815 strip ready ("
+              << pixels.size() << " px on "
+              << strip.device  << " @ "
+              << spiSpeedHz() / 1000000.0 << " MHz, "
+              << (strip.encoding == LedEncoding::Spi3Bit ? 3 : 8) << " SPI bits per bit)\n";
+
+    if (segmentTable.empty()) {
+        std::cout << "LED: (no face segments loaded – "
+                     "see config/led_segments.conf)\n";
     } else {
-        std::cout << "LED: " << kFaceSegments.size()
+        std::cout << "LED: " << segmentTable.size()
                   << " face segment(s) registered\n";
-        for (const auto& seg : kFaceSegments) {
+        for (const auto& seg : segmentTable) {
             std::cout << "  · " << seg.name
                       << "  [" << seg.start
                       << ".." << (seg.start + seg.count - 1) << "]\n";
@@ -104,6 +276,14 @@ void LedController::stop() {
     if (spiFd >= 0) {
         clear();
         show();
+
+        // Join the render thread, then push the dark frame ourselves so the
+        // strip is guaranteed off regardless of where the clock was (and
+        // of any effects still installed)
+        rendering = false;
+        if (renderThread.joinable()) renderThread.join();
+        renderFrame(true);
+
         close(spiFd);
         spiFd = -1;
         std::cout << "LED: strip shut down\n";
@@ -141,90 +321,387 @@ void LedController::clear() {
     fill(0, 0, 0);
 }
 
-// ─── Segment helpers ────────────────────────────────────────────────────────
+// ─── Segment map ────────────────────────────────────────────────────────────
 
-const std::vector<LedSegment>& LedController::segments() const {
-    return kFaceSegments;
+bool LedController::loadSegments(const char* path) {
+    std::ifstream file(path);
+    if (!file) {
+        std::cerr << "LED: cannot open segment map " << path << '\n';
+        return false;
+    }
+
+    std::vector<LedSegment> table;
+    std::unordered_map<std::string, LedSegmentId> ids;
+    std::string line;
+    for (int lineNo = 1; std::getline(file, line); ++lineNo) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string name;
+        if (!(fields >> name)) continue;                    // blank / comment
+
+        long start = -1;
+        long count = -1;
+        std::string extra;
+        if (!(fields >> start >> count) || (fields >> extra)) {
+            std::cerr << "LED: " << path << ':' << lineNo
+                      << ": expected \"name start count\"\n";
+            return false;
+        }
+        if (start < 0 || count <= 0 || start + count > static_cast<long>(pixels.size())) {
+            std::cerr << "LED: " << path << ':' << lineNo << ": segment '" << name
+                      << "' does not fit the " << pixels.size() << "-pixel strip\n";
+            return false;
+        }
+        if (table.size() >= static_cast<size_t>(LedSegmentId::Invalid)) {
+            std::cerr << "LED: " << path << ':' << lineNo << ": too many segments\n";
+            return false;
+        }
+
+        const auto id = static_cast<LedSegmentId>(table.size());
+        if (!ids.emplace(name, id).second) {
+            std::cerr << "LED: " << path << ':' << lineNo
+                      << ": duplicate segment '" << name << "'\n";
+            return false;
+        }
+        table.push_back({name, static_cast<uint16_t>(start), static_cast<uint16_t>(count)});
+    }
+
+    segmentTable = std::move(table);
+    segmentIds = std::move(ids);
+    std::cout << "LED: loaded " << segmentTable.size()
+              << " face segment(s) from " << path << '\n';
+    return true;
+}
+
+LedSegmentId LedController::segmentId(const char* name) const {
+    auto it = segmentIds.find(name);
+    return it == segmentIds.end() ? LedSegmentId::Invalid : it->second;
+}
+
+const LedSegment* LedController::segment(LedSegmentId id) const {
+    const auto index = static_cast<size_t>(id);
+    return index < segmentTable.size() ? &segmentTable[index] : nullptr;
 }
 
 const LedSegment* LedController::findSegment(const char* name) const {
-    for (const auto& seg : kFaceSegments) {
-        if (std::strcmp(seg.name, name) == 0) return &seg;
-    }
-    return nullptr;
+    return segment(segmentId(name));
 }
 
-void LedController::fillSegment(const char* name, const Pixel& px) {
-    const auto* seg = findSegment(name);
+// ─── Segment helpers ────────────────────────────────────────────────────────
+
+const std::vector<LedSegment>& LedController::segments() const {
+    return segmentTable;
+}
+
+void LedController::fillSegment(LedSegmentId id, const Pixel& px) {
+    const auto* seg = segment(id);
     if (!seg) return;
     std::lock_guard<std::mutex> lk(bufferMutex);
-    uint16_t end = std::min<uint16_t>(seg->start + seg->count,
-                                       static_cast<uint16_t>(pixels.size()));
-    for (uint16_t i = seg->start; i < end; ++i) {
-        pixels[i] = px;
-    }
+    std::fill_n(pixels.begin() + seg->start, seg->count, px);
+}
+
+void LedController::fillSegment(LedSegmentId id, uint8_t r, uint8_t g, uint8_t b) {
+    fillSegment(id, Pixel{r, g, b});
+}
+
+void LedController::fillSegment(const char* name, const Pixel& px) {
+    fillSegment(segmentId(name), px);
 }
 
 void LedController::fillSegment(const char* name, uint8_t r, uint8_t g, uint8_t b) {
-    fillSegment(name, Pixel{r, g, b});
+    fillSegment(segmentId(name), Pixel{r, g, b});
+}
+
+int LedController::addEffect(LedSegmentId id, LedEffect effect) {
+    const auto* seg = segment(id);
+    if (!seg) return -1;
+    effect.start = seg->start;
+    effect.count = seg->count;
+    return effectEngine.add(effect);
+}
+
+int LedController::addEffect(const char* segment, LedEffect effect) {
+    return addEffect(segmentId(segment), effect);
 }
 
 // ─── Brightness ─────────────────────────────────────────────────────────────
 
 void LedController::setBrightness(uint8_t b) {
-    brightness = b;
+    // The render thread notices the change and rebuilds its lookup tables
+    brightness.store(b, std::memory_order_relaxed);
 }
 
 uint8_t LedController::getBrightness() const {
-    return brightness;
+    return brightness.load(std::memory_order_relaxed);
+}
+
+void LedController::setGamma(float red, float green, float blue) {
+    gamma[0].store(red, std::memory_order_relaxed);
+    gamma[1].store(green, std::memory_order_relaxed);
+    gamma[2].store(blue, std::memory_order_relaxed);
+}
+
+void LedController::setDithering(bool enabled) {
+    dithering.store(enabled, std::memory_order_relaxed);
+}
+
+void LedController::setDitherSettleFrames(unsigned frames) {
+    ditherSettleFrames.store(frames, std::memory_order_relaxed);
+}
+
+void LedController::setCurrentBudget(unsigned milliamps) {
+    currentBudgetMa.store(milliamps, std::memory_order_relaxed);
+}
+
+void LedController::setKeepAliveInterval(unsigned ms) {
+    keepAliveMs.store(ms, std::memory_order_relaxed);
 }
 
 // ─── SPI NRZ encoding ───────────────────────────────────────────────────────
 
-void LedController::encodeByte(uint8_t byte, std::vector<uint8_t>& out) const {
-    for (int bit = 7; bit >= 0; --bit) {
-        out.push_back((byte & (1 << bit)) ? BIT_ONE : BIT_ZERO);
+bool LedController::refreshGammaLut() {
+    const uint8_t level = brightness.load(std::memory_order_relaxed);
+    const std::array<float, 3> wanted{gamma[0].load(std::memory_order_relaxed),
+                                      gamma[1].load(std::memory_order_relaxed),
+                                      gamma[2].load(std::memory_order_relaxed)};
+    if (level == lutBrightness && wanted == lutGamma) return false;
+
+    // Gamma first, then the linear brightness scale, kept in 8.8 fixed
+    // point so the dither stage has the fraction to work with
+    lutBrightness = level;
+    lutGamma = wanted;
+    for (size_t ch = 0; ch < 3; ++ch) {
+        for (unsigned v = 0; v < 256; ++v) {
+            const double corrected = std::pow(v / 255.0, static_cast<double>(wanted[ch]));
+            gammaLut[ch][v] = static_cast<uint16_t>(std::lround(corrected * level * 256.0));
+        }
     }
+    return true;
 }
 
-void LedController::buildSpiFrame(std::vector<uint8_t>& frame) const {
-    // 8 SPI bytes per colour byte × 3 colours per pixel + reset
-    const size_t dataBytes = pixels.size() * 3 * 8;
-    frame.clear();
-    frame.reserve(dataBytes + RESET_BYTES);
+uint32_t LedController::spiSpeedHz() const {
+    return strip.encoding == LedEncoding::Spi3Bit ? Constants::LED_SPI3_SPEED_HZ
+                                                  : Constants::LED_SPI_SPEED_HZ;
+}
 
-    // WS2815 expects GRB byte order
-    for (const auto& px : pixels) {
-        auto scale = [this](uint8_t ch) -> uint8_t {
-            return static_cast<uint8_t>((static_cast<uint16_t>(ch) * brightness) / 255);
-        };
-        encodeByte(scale(px.g), frame);
-        encodeByte(scale(px.r), frame);
-        encodeByte(scale(px.b), frame);
+size_t LedController::frameBytes() const {
+    // SPI bytes per colour byte × 3 colours per pixel + reset
+    if (strip.encoding == LedEncoding::Spi3Bit) {
+        return pixels.size() * 3 * SPI3_BYTES_PER_CHANNEL + RESET3_BYTES;
+    }
+    return pixels.size() * 3 * SPI_BYTES_PER_CHANNEL + RESET_BYTES;
+}
+
+void LedController::buildSpiFrame(const std::vector<Pixel>& source, uint8_t* out) {
+    const unsigned budgetMa = currentBudgetMa.load(std::memory_order_relaxed);
+    const uint32_t budget = budgetMa * 255u / Constants::LED_CHANNEL_FULL_SCALE_MA;
+
+    uint32_t sum = encodeFrame(source, out, limitScale);
+    limiterPending = false;
+    if (budgetMa != 0 && sum > budget) {
+        // Over budget: scale down to fit and re-encode before anything is
+        // sent (same dither phase, so nothing else changes)
+        limitScale = std::max(1u, static_cast<unsigned>(uint64_t{limitScale} * budget / sum));
+        sum = encodeFrame(source, out, limitScale);
+    } else if (limitScale < 256 && (budgetMa == 0 || uint64_t{sum} * 8 < uint64_t{budget} * 7)) {
+        // Comfortably under: release a step per frame (~0.5 s to recover)
+        limitScale = std::min(256u, limitScale + 8);
+        limiterPending = true;
     }
 
-    // Reset code (low for ≥280 µs)
-    frame.insert(frame.end(), RESET_BYTES, 0x00);
+    estimatedMa.store(sum * Constants::LED_CHANNEL_FULL_SCALE_MA / 255u, std::memory_order_relaxed);
+    limitScaleOut.store(limitScale, std::memory_order_relaxed);
+    ditherPhase = (ditherPhase + 1) & (Constants::LED_DITHER_CYCLE_FRAMES - 1);
 }
 
-// ─── Flush to strip ─────────────────────────────────────────────────────────
+uint32_t LedController::encodeFrame(const std::vector<Pixel>& source, uint8_t* out, unsigned scale) {
+    uint32_t sum;
+    if (strip.encoding == LedEncoding::Spi3Bit) {
+        sum = encodePixels(source, scale, [&out](unsigned value) {
+            std::memcpy(out, &kNrz3Patterns[value], sizeof(uint32_t));
+            out += SPI3_BYTES_PER_CHANNEL;
+        });
+        std::memset(out, 0x00, RESET3_BYTES);
+    } else {
+        sum = encodePixels(source, scale, [&out](unsigned value) {
+            std::memcpy(out, &kNrzPatterns[value], SPI_BYTES_PER_CHANNEL);
+            out += SPI_BYTES_PER_CHANNEL;
+        });
+        std::memset(out, 0x00, RESET_BYTES);
+    }
+    return sum;
+}
+
+template <typename Emit>
+uint32_t LedController::encodePixels(const std::vector<Pixel>& source, unsigned scale, Emit emit) {
+    const bool dither = dithering.load(std::memory_order_relaxed) && !ditherSettled;
+    unsigned phase = ditherPhase;               // channel i uses step (frame + i) of the cycle
+    bool varying = false;
+    uint32_t sum = 0;                           // Σ output bytes → current estimate
+
+    // 8.8 level → output byte: add this frame's threshold and truncate, or
+    // round.  A fraction below the smallest threshold (or at or above the
+    // largest) gives the same byte on every step of the cycle.
+    auto encode = [&](uint16_t gammaLevel) {
+        const unsigned level = (gammaLevel * scale) >> 8;
+        unsigned value;
+        if (dither) {
+            value = level + kDitherThresholds[phase++ & (Constants::LED_DITHER_CYCLE_FRAMES - 1)];
+            // Unsigned wrap: one compare for threshold[0] <= fraction < 256 - threshold[0]
+            varying |= (level & 0xFFu) - kDitherThresholds[0] < 256u - 2u * kDitherThresholds[0];
+        } else {
+            value = level + 0x80u;
+        }
+        sum += value >> 8;
+        emit(value >> 8);
+    };
+
+    // WS2815 expects GRB byte order
+    for (const auto& px : source) {
+        encode(gammaLut[1][px.g]);
+        encode(gammaLut[0][px.r]);
+        encode(gammaLut[2][px.b]);
+    }
+    ditherPending = varying;
+    return sum;
+}
+
+// ─── Publish / render ───────────────────────────────────────────────────────
 
 void LedController::show() {
-    if (spiFd < 0) return;
+    // Snapshot the canvas into our private slot, then swap it into the
+    // middle and mark it fresh.  A frame the render thread has not picked
+    // up yet is simply replaced – it only ever sends the newest one.
+    std::lock_guard<std::mutex> lk(bufferMutex);
+    std::copy(pixels.begin(), pixels.end(), frameSlots[writeSlot].begin());
+    writeSlot = middleSlot.exchange(writeSlot | SLOT_FRESH, std::memory_order_acq_rel)
+              & SLOT_INDEX_MASK;
+}
 
-    std::vector<uint8_t> frame;
-    {
-        std::lock_guard<std::mutex> lk(bufferMutex);
-        buildSpiFrame(frame);
+void LedController::renderWorker() {
+    RealTime::configureCurrentThread(RealtimeConfig{}, "led-render");
+
+    using Clock = std::chrono::steady_clock;
+    const auto period = std::chrono::duration_cast<Clock::duration>(
+        std::chrono::milliseconds(Constants::LED_REFRESH_INTERVAL_MS));
+
+    // Next multiple of the period on the shared steady clock, so every
+    // strip's render thread starts its transfer at the same instant
+    auto nextTick = [&](Clock::time_point t) {
+        return Clock::time_point((t.time_since_epoch() / period + 1) * period);
+    };
+
+    auto nextFrame = nextTick(Clock::now());
+    while (rendering) {
+        std::this_thread::sleep_until(nextFrame);
+        renderFrame(false);
+
+        // Fixed frame clock; if a transfer overran, resync rather than burst
+        nextFrame += period;
+        const auto now = Clock::now();
+        if (nextFrame < now) nextFrame = nextTick(now);
+    }
+}
+
+void LedController::renderFrame(bool shutdown) {
+    if (middleSlot.load(std::memory_order_relaxed) & SLOT_FRESH) {
+        readSlot = middleSlot.exchange(readSlot, std::memory_order_acq_rel)
+                 & SLOT_INDEX_MASK;
+        frameDirty = true;
+    }
+
+    // A recovering limiter keeps changing the output until it settles
+    const unsigned budgetMa = currentBudgetMa.load(std::memory_order_relaxed);
+    const bool budgetChanged = budgetMa != appliedBudgetMa;
+    appliedBudgetMa = budgetMa;
+    bool outputChanged = refreshGammaLut() || limiterPending || budgetChanged;
+
+    const auto now = std::chrono::steady_clock::now();
+
+    // Effects animate on the render clock, so any active effect means a
+    // new frame every tick; the hash below still drops static results
+    const std::vector<Pixel>* source = &frameSlots[readSlot];
+    if (!shutdown && !effectEngine.empty()) {
+        const auto start = std::chrono::steady_clock::now();
+        std::copy(source->begin(), source->end(), composeBuffer.begin());
+        const auto nowMs = std::chrono::duration_cast<std::chrono::milliseconds>(
+            now.time_since_epoch()).count();
+        effectEngine.render(composeBuffer.data(), static_cast<uint16_t>(composeBuffer.size()),
+                            static_cast<uint32_t>(nowMs));
+        source = &composeBuffer;
+        frameDirty = true;
+
+        const auto elapsed = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - start).count());
+        effectNs.store(elapsed, std::memory_order_relaxed);
+        if (elapsed > effectMaxNs.load(std::memory_order_relaxed)) {
+            effectMaxNs.store(elapsed, std::memory_order_relaxed);
+        }
+    }
+
+    // Only a change in the pixels themselves restarts the settle count; an
+    // identical republished or composed frame counts as static
+    if (frameDirty) {
+        const uint64_t hash = hashFrame(*source);
+        if (hash != sourceHash) {
+            sourceHash = hash;
+            outputChanged = true;
+        }
+    }
+    const unsigned settleFrames = ditherSettleFrames.load(std::memory_order_relaxed);
+    if (outputChanged) {
+        ditherFrames = 0;
+        frameDirty = true;
+    } else if (ditherPending) {
+        // Next step of the cycle; with a settle limit, the tick that
+        // reaches it encodes the rounded frame
+        ditherFrames += ditherFrames < settleFrames;
+        frameDirty = true;
+    }
+    ditherSettled = settleFrames != 0 && ditherFrames >= settleFrames;
+
+    const unsigned keepAlive = keepAliveMs.load(std::memory_order_relaxed);
+    const bool keepAliveDue =
+        keepAlive != 0 && now - lastSent >= std::chrono::milliseconds(keepAlive);
+
+    // Nothing published and nothing to refresh: the strip already shows this
+    if (!frameDirty && !keepAliveDue && !shutdown) {
+        skippedFrames.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    // Keep-alive of an unchanged frame resends the front (last sent) frame
+    const std::vector<uint8_t>* out = &spiFrames[backFrame ^ 1];
+    bool encoded = false;
+    if (frameDirty) {
+        std::vector<uint8_t>& frame = spiFrames[backFrame];
+        buildSpiFrame(*source, frame.data());
+        frameDirty = false;
+
+        // A republished but identical frame (e.g. a static face redrawn
+        // every loop) encodes to the same bytes; keep it off the bus
+        const uint64_t hash = hashFrame(frame);
+        if (hash == sentHash && !keepAliveDue && !shutdown) {
+            skippedFrames.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        sentHash = hash;
+        out = &frame;
+        encoded = true;
     }
 
     struct spi_ioc_transfer xfer{};
-    xfer.tx_buf        = reinterpret_cast<uintptr_t>(frame.data());
-    xfer.len           = static_cast<uint32_t>(frame.size());
-    xfer.speed_hz      = Constants::LED_SPI_SPEED_HZ;
+    xfer.tx_buf        = reinterpret_cast<uintptr_t>(out->data());
+    xfer.len           = static_cast<uint32_t>(out->size());
+    xfer.speed_hz      = spiSpeedHz();
     xfer.bits_per_word = 8;
 
     if (ioctl(spiFd, SPI_IOC_MESSAGE(1), &xfer) < 0) {
-        std::cerr << "LED: SPI transfer failed: " << strerror(errno) << '\n';
+        std::cerr << "LED: SPI transfer failed on " << strip.device << ": "
+                  << strerror(errno) << '\n';
     }
+
+    lastSent = now;
+    sentFrames.fetch_add(1, std::memory_order_relaxed);
+    if (encoded) backFrame ^= 1;
 }
@@ -1,56 +1,63 @@
 #pragma once
+#include <array>
 #include <atomic>
+#include <chrono>
 #include <cstdint>
 #include <mutex>
 #include <string>
 #include <thread>
+#include <unordered_map>
 #include <vector>
 #include "Constants.hpp"
+#include "LedEffects.hpp"
+#include "LedTypes.hpp"
 
-// ─── Pixel representation ───────────────────────────────────────────────────
-struct Pixel {
-    uint8_t r = 0;
-    uint8_t g = 0;
-    uint8_t b = 0;
-};
-
-// ─── Named face-segment descriptor ─────────────────────────────────────────
+// ─── Strip descriptor ───────────────────────────────────────────────────────
 //
-//  Each segment is a contiguous run of pixels on the strip that maps to a
-//  logical region of the robot's face (e.g. "left eye", "mouth").
+//  One strip per spidev bus.  Each LedController owns one strip with its
+//  own render thread, so several controllers transfer concurrently.
 //
-//  Populate the table in LedController.cpp → kFaceSegments once the physical
-//  layout is finalised.  Until then the controller still works; callers can
-//  address raw pixel indices or iterate segments that have been defined.
-//
-struct LedSegment {
-    const char* name;   // human-readable label  ("left_eye", "mouth", …)
-    uint16_t    start;  // first pixel index (0-based)
-    uint16_t    count;  // number of pixels in this segment
+enum class LedEncoding : uint8_t {
+    Spi8Bit,    // 8 SPI bits per NRZ bit @ LED_SPI_SPEED_HZ:  24 bytes/pixel
+    Spi3Bit,    // 3 SPI bits per NRZ bit @ LED_SPI3_SPEED_HZ:  9 bytes/pixel
+};
+
+struct LedStripConfig {
+    std::string device   = Constants::LED_SPI_DEVICE;
+    uint16_t pixelCount  = Constants::LED_PIXEL_COUNT;
+    LedEncoding encoding = LedEncoding::Spi8Bit;
 };
 
 // ─── LED Controller ─────────────────────────────────────────────────────────
 //
-//  Drives the WS2815 144-pixel strip over SPI (default /dev/spidev0.0).
+//  Drives a WS2815 strip over SPI (default: 144 pixels on /dev/spidev0.0).
 //  WS2815 uses the same protocol as WS2812B (800 kHz NRZ, GRB byte order)
 //  but runs on a 12 V rail with a separate data line (3.3→5 V level-shift).
 //
+//  SPI output runs on a render thread with a fixed LED_REFRESH_INTERVAL_MS
+//  frame clock.  show() only publishes the framebuffer through a lock-free
+//  triple buffer, so callers never wait on the (≈4.4 ms) SPI transfer.
+//  The clock is aligned to multiples of the interval, so controllers for
+//  separate strips tick – and transfer on their own buses – together.
+//
 //  Usage:
 //      LedController leds;
+//      leds.loadSegments("config/led_segments.conf");
 //      if (!leds.initialize()) { /* handle error */ }
 //      leds.setPixel(0, 255, 0, 0);       // first pixel red
-//      leds.fillSegment("left_eye", {0, 0, 255});
-//      leds.show();                        // flush to strip
+//      auto eye = leds.segmentId("left_eye");   // resolve once…
+//      leds.fillSegment(eye, {0, 0, 255});      // …then O(1) per call
+//      leds.show();                        // publish to the render thread
 //
 class LedController {
 public:
-    LedController();
+    explicit LedController(const LedStripConfig& config = {});
     ~LedController();
 
-    /// Open the SPI device and allocate the framebuffer.
+    /// Open the SPI device and start the render thread.
     bool initialize();
 
-    /// Turn off all pixels and release SPI.
+    /// Turn off all pixels, stop the render thread and release SPI.
     void stop();
 
     // ── Raw pixel access ────────────────────────────────────────────────
@@ -61,31 +68,174 @@ public:
     void fill(const Pixel& px);
     void clear();                       // fill(0,0,0)
 
-    // ── Segment helpers (no-op if segment name not found) ───────────────
+    // ── Segment map ─────────────────────────────────────────────────────
+
+    /// Replace the segment table from a map file: one "name start count"
+    /// per line, '#' starts a comment.  Call before initialize(); on any
+    /// error the current table is kept and false is returned.
+    bool loadSegments(const char* path);
+
+    /// Interned id for a segment name, or LedSegmentId::Invalid.
+    LedSegmentId segmentId(const char* name) const;
+    const LedSegment* segment(LedSegmentId id) const;
+    const LedSegment* findSegment(const char* name) const;
+
+    // ── Segment helpers (no-op if the segment is unknown) ───────────────
+    void fillSegment(LedSegmentId id, const Pixel& px);
+    void fillSegment(LedSegmentId id, uint8_t r, uint8_t g, uint8_t b);
     void fillSegment(const char* name, const Pixel& px);
     void fillSegment(const char* name, uint8_t r, uint8_t g, uint8_t b);
-    const LedSegment* findSegment(const char* name) const;
 
-    /// Flush the current pixel buffer to the strip over SPI.
+    /// Publish the current pixel buffer; the render thread sends it on
+    /// its next frame tick.  Never blocks on SPI.
     void show();
 
-    /// Set global brightness scalar (0–255).  Applied on show().
+    /// Set global brightness scalar (0–255).  Applied on the next frame.
     void setBrightness(uint8_t brightness);
     uint8_t getBrightness() const;
 
+    /// Per-channel output gamma (1.0 = linear).  Applied on the next frame.
+    void setGamma(float red, float green, float blue);
+
+    /// Temporal dithering: the gamma stage keeps 8 fractional bits, and
+    /// each channel steps through a fixed LED_DITHER_CYCLE_FRAMES threshold
+    /// pattern, so dim levels average out instead of banding.  The pattern
+    /// repeats exactly, so a static frame looks the same for as long as it
+    /// is shown; only channels at an exact level stop changing (and frames
+    /// that encode identically to the last one sent are skipped).
+    void setDithering(bool enabled);
+
+    /// Round a frame once its source has been static for this many frames
+    /// and stop sending it (0 = keep dithering, the default).  Saves the
+    /// SPI traffic of a dim still face, at the cost of up to half an LSB
+    /// step in level at that moment.
+    void setDitherSettleFrames(unsigned frames);
+
+    /// Cap the strip's estimated 12 V draw.  Every encoded frame is summed
+    /// and, if it would exceed the budget, re-encoded with the output scaled
+    /// down; the scale recovers gradually once the face dims.  0 = no limit.
+    void setCurrentBudget(unsigned milliamps);
+
+    /// Estimated draw of the last encoded frame, after limiting.
+    unsigned estimatedCurrentMa() const { return estimatedMa.load(std::memory_order_relaxed); }
+
+    /// Limiter output scale in Q8 (256 = not limiting).
+    unsigned currentLimitScale() const { return limitScaleOut.load(std::memory_order_relaxed); }
+
+    /// Resend an unchanged frame at least this often (0 = only on change),
+    /// to recover from glitches on the data line.
+    void setKeepAliveInterval(unsigned ms);
+
+    /// Render-thread frame counters: frames sent over SPI, and ticks that
+    /// were skipped because the encoded frame had not changed.
+    uint64_t framesSent() const { return sentFrames.load(std::memory_order_relaxed); }
+    uint64_t framesSkipped() const { return skippedFrames.load(std::memory_order_relaxed); }
+
     /// Total pixel count on the strip.
-    uint16_t pixelCount() const { return Constants::LED_PIXEL_COUNT; }
+    uint16_t pixelCount() const { return static_cast<uint16_t>(pixels.size()); }
+    const std::string& device() const { return strip.device; }
 
     /// Read-only view of the registered face segments.
     const std::vector<LedSegment>& segments() const;
 
+    /// Animated effects, evaluated by the render thread on top of the
+    /// last shown frame every tick (see LedEffects.hpp).
+    LedEffectEngine& effects() { return effectEngine; }
+
+    /// Add an effect bound to a segment.  Returns the effect id, or -1 if
+    /// the segment is unknown or the effect table is full.
+    int addEffect(LedSegmentId segment, LedEffect effect);
+    int addEffect(const char* segment, LedEffect effect);
+
+    /// Time the render thread spent evaluating effects: last frame / worst.
+    uint32_t effectRenderNs() const { return effectNs.load(std::memory_order_relaxed); }
+    uint32_t effectRenderMaxNs() const { return effectMaxNs.load(std::memory_order_relaxed); }
+
 private:
+    friend class LedControllerBench;            // bench/LedBench.cpp
+    friend class LedControllerTest;             // tests/LedControllerTest.cpp
+
+    LedStripConfig strip;
     int spiFd = -1;                             // file descriptor for SPI device
-    uint8_t brightness = Constants::LED_DEFAULT_BRIGHTNESS;
-    std::vector<Pixel> pixels;                  // logical framebuffer
-    mutable std::mutex bufferMutex;             // guards pixels[]
+
+    // Segment table indexed by LedSegmentId, plus the name → id intern map
+    std::vector<LedSegment> segmentTable;
+    std::unordered_map<std::string, LedSegmentId> segmentIds;
+    std::atomic<uint8_t> brightness{Constants::LED_DEFAULT_BRIGHTNESS};
+    std::vector<Pixel> pixels;                  // logical framebuffer (producers' canvas)
+    mutable std::mutex bufferMutex;             // guards pixels[] and writeSlot between producers
+
+    // Triple buffer between show() and the render thread.  The producer
+    // owns writeSlot, the render thread owns readSlot, and the third index
+    // lives in middleSlot together with a "fresh frame" flag.
+    static constexpr uint8_t SLOT_INDEX_MASK = 0x03;
+    static constexpr uint8_t SLOT_FRESH = 0x04;
+    std::array<std::vector<Pixel>, 3> frameSlots;
+    uint8_t writeSlot = 0;
+    uint8_t readSlot = 1;
+    std::atomic<uint8_t> middleSlot{2};
+
+    // Render thread state (render thread only once started)
+    std::thread renderThread;
+    std::atomic<bool> rendering{false};
+    std::array<std::atomic<float>, 3> gamma{Constants::LED_GAMMA_RED,
+                                            Constants::LED_GAMMA_GREEN,
+                                            Constants::LED_GAMMA_BLUE};
+    std::atomic<bool> dithering{Constants::LED_TEMPORAL_DITHER};
+
+    // Output stage (render thread): colour byte → gamma-corrected,
+    // brightness-scaled level in 8.8 fixed point, per channel (R, G, B),
+    // then the dither residual of every channel on the strip.
+    uint8_t lutBrightness = 0;
+    std::array<float, 3> lutGamma{};
+    std::array<std::array<uint16_t, 256>, 3> gammaLut{};
+    unsigned ditherPhase = 0;                   // position in the dither cycle
+    bool ditherPending = false;                 // last frame had channels between levels
+    std::atomic<unsigned> ditherSettleFrames{Constants::LED_DITHER_SETTLE_FRAMES};
+    unsigned ditherFrames = 0;                  // dithered ticks since the source last changed
+    bool ditherSettled = false;                 // static long enough: round instead
+    uint64_t sourceHash = 0;                    // pixels the output stage last encoded from
+
+    // Power limiter: Q8 scale on every output level, owned by the render
+    // thread; the budget and the estimate are shared with callers
+    std::atomic<unsigned> currentBudgetMa{Constants::LED_CURRENT_BUDGET_MA};
+    std::atomic<unsigned> estimatedMa{0};
+    std::atomic<unsigned> limitScaleOut{256};
+    unsigned limitScale = 256;
+    unsigned appliedBudgetMa = 0;
+    bool limiterPending = false;                // scale still recovering
+
+    // Effects are composed over a copy of the read slot so the published
+    // frame stays untouched between ticks
+    LedEffectEngine effectEngine;
+    std::vector<Pixel> composeBuffer;
+    std::atomic<uint32_t> effectNs{0};
+    std::atomic<uint32_t> effectMaxNs{0};
+
+    // Dirty tracking: a tick only re-encodes when a new frame was published
+    // or the brightness changed, and only transfers when the encoded frame's
+    // hash differs from the last one sent (or the keep-alive is due).
+    std::atomic<unsigned> keepAliveMs{Constants::LED_KEEPALIVE_INTERVAL_MS};
+    bool frameDirty = true;
+    uint64_t sentHash = 0;
+    std::chrono::steady_clock::time_point lastSent{};
+    std::atomic<uint64_t> sentFrames{0};
+    std::atomic<uint64_t> skippedFrames{0};
+
+    // Encoded SPI frames, preallocated; each frame is encoded into the back
+    // one, transferred, and the two swap.
+    std::array<std::vector<uint8_t>, 2> spiFrames;
+    int backFrame = 0;
+
+    void renderWorker();
+    void renderFrame(bool shutdown);            // shutdown: send the bare frame unconditionally
 
     // SPI bit-stream encoding (WS2815 NRZ protocol)
-    void encodeByte(uint8_t byte, std::vector<uint8_t>& out) const;
-    void buildSpiFrame(std::vector<uint8_t>& frame) const;
+    bool refreshGammaLut();                     // true if the output stage changed
+    uint32_t spiSpeedHz() const;
+    size_t frameBytes() const;
+    void buildSpiFrame(const std::vector<Pixel>& source, uint8_t* out);   // writes exactly frameBytes()
+    uint32_t encodeFrame(const std::vector<Pixel>& source, uint8_t* out, unsigned scale);
+    template <typename Emit>
+    uint32_t encodePixels(const std::vector<Pixel>& source, unsigned scale, Emit emit);
 };
@@ -0,0 +1,180 @@
+#include "LedEffects.hpp"
+#include <algorithm>
+#include <cstdlib>
+#include "Constants.hpp"
+
+// ─── 8-bit fixed-point helpers ──────────────────────────────────────────────
+
+static inline uint8_t scale8(uint8_t value, uint8_t level) {
+    return static_cast<uint8_t>((value * (level + 1u)) >> 8);
+}
+
+static inline Pixel scalePixel(const Pixel& px, uint8_t level) {
+    return {scale8(px.r, level), scale8(px.g, level), scale8(px.b, level)};
+}
+
+static inline uint8_t addSaturate(uint8_t a, uint8_t b) {
+    const unsigned sum = a + b;
+    return static_cast<uint8_t>(sum > 255 ? 255 : sum);
+}
+
+/// Position within the current period, 0–255.
+static inline uint8_t phase8(uint32_t nowMs, uint16_t periodMs) {
+    if (periodMs == 0) return 0;
+    return static_cast<uint8_t>(((nowMs % periodMs) << 8) / periodMs);
+}
+
+/// 0 → 254 → 0 over one phase.
+static inline uint8_t triangle8(uint8_t phase) {
+    return static_cast<uint8_t>(phase < 128 ? phase << 1 : (255 - phase) << 1);
+}
+
+/// Smoothstep 3t² − 2t³ on 0–255.
+static inline uint8_t ease8(uint8_t t) {
+    return static_cast<uint8_t>((t * t * (768u - 2u * t)) >> 16);
+}
+
+/// Fully saturated hue wheel, 0–255 → R → G → B → R.
+static inline Pixel hue8(uint8_t hue) {
+    const uint8_t sector = hue / 85;
+    const uint8_t ramp = static_cast<uint8_t>((hue - sector * 85) * 3);
+    switch (sector) {
+        case 0:  return {static_cast<uint8_t>(255 - ramp), ramp, 0};
+        case 1:  return {0, static_cast<uint8_t>(255 - ramp), ramp};
+        default: return {ramp, 0, static_cast<uint8_t>(255 - ramp)};
+    }
+}
+
+static inline void blendInto(Pixel& dst, const Pixel& src, LedBlend blend) {
+    if (blend == LedBlend::Replace) {
+        dst = src;
+    } else {
+        dst = {addSaturate(dst.r, src.r), addSaturate(dst.g, src.g), addSaturate(dst.b, src.b)};
+    }
+}
+
+// ─── Effect table ───────────────────────────────────────────────────────────
+
+int LedEffectEngine::add(const LedEffect& effect) {
+    std::lock_guard<std::mutex> lk(editMutex);
+    for (size_t i = 0; i < MAX_EFFECTS; ++i) {
+        if (!editing.used[i]) {
+            editing.effects[i] = effect;
+            editing.used[i] = true;
+            publishLocked();
+            activeCount.fetch_add(1, std::memory_order_relaxed);
+            return static_cast<int>(i);
+        }
+    }
+    return -1;
+}
+
+bool LedEffectEngine::remove(int id) {
+    if (id < 0 || static_cast<size_t>(id) >= MAX_EFFECTS) return false;
+    std::lock_guard<std::mutex> lk(editMutex);
+    if (!editing.used[id]) return false;
+    editing.used[id] = false;
+    publishLocked();
+    activeCount.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+void LedEffectEngine::clear() {
+    std::lock_guard<std::mutex> lk(editMutex);
+    editing.used.fill(false);
+    publishLocked();
+    activeCount.store(0, std::memory_order_relaxed);
+}
+
+void LedEffectEngine::publishLocked() {
+    // A table render() has not picked up yet is simply replaced
+    tables[writeTable] = editing;
+    writeTable = middleTable.exchange(writeTable | TABLE_FRESH, std::memory_order_acq_rel)
+               & TABLE_INDEX_MASK;
+}
+
+void LedEffectEngine::setLook(int16_t x, int16_t y) {
+    // One word, so a frame never pairs x and y from different updates
+    look.store(static_cast<uint16_t>(x) | (static_cast<uint32_t>(static_cast<uint16_t>(y)) << 16),
+               std::memory_order_relaxed);
+}
+
+// ─── Per-frame evaluation ───────────────────────────────────────────────────
+
+void LedEffectEngine::render(Pixel* frame, uint16_t pixelCount, uint32_t nowMs) {
+    const uint32_t packed = look.load(std::memory_order_relaxed);
+    const int32_t x = static_cast<int16_t>(packed & 0xFFFF);
+    const int32_t y = static_cast<int16_t>(packed >> 16);
+
+    if (middleTable.load(std::memory_order_relaxed) & TABLE_FRESH) {
+        readTable = middleTable.exchange(readTable, std::memory_order_acq_rel) & TABLE_INDEX_MASK;
+    }
+    const EffectTable& table = tables[readTable];
+
+    // Slots are evaluated in index order; add() fills the lowest free slot
+    for (size_t slot = 0; slot < MAX_EFFECTS; ++slot) {
+        if (!table.used[slot]) continue;
+        const LedEffect& fx = table.effects[slot];
+        if (fx.start >= pixelCount) continue;
+
+        const uint16_t available = static_cast<uint16_t>(pixelCount - fx.start);
+        const uint16_t count = fx.count == 0 ? available : std::min(fx.count, available);
+        Pixel* range = frame + fx.start;
+        const uint8_t phase = phase8(nowMs, fx.periodMs);
+
+        switch (fx.type) {
+            case LedEffectType::Solid:
+            case LedEffectType::Breathe:
+            case LedEffectType::Blink: {
+                uint8_t level = 255;
+                if (fx.type == LedEffectType::Breathe) level = ease8(triangle8(phase));
+                if (fx.type == LedEffectType::Blink)   level = phase < fx.duty ? 255 : 0;
+                const Pixel px = scalePixel(fx.colour, level);
+                for (uint16_t i = 0; i < count; ++i) blendInto(range[i], px, fx.blend);
+                break;
+            }
+
+            case LedEffectType::Chase: {
+                // Head advances one lap per period; tail fades linearly
+                const uint16_t head = static_cast<uint16_t>((phase * count) >> 8);
+                const unsigned width = std::max<unsigned>(fx.width, 1);
+                for (uint16_t i = 0; i < count; ++i) {
+                    const unsigned behind = (head + count - i) % count;
+                    const uint8_t level = behind < width
+                        ? static_cast<uint8_t>(255 - (behind * 255) / width) : 0;
+                    blendInto(range[i], scalePixel(fx.colour, level), fx.blend);
+                }
+                break;
+            }
+
+            case LedEffectType::Rainbow: {
+                const unsigned hueStep = (256u << 8) / count;         // Q8 hue per pixel
+                unsigned hue = static_cast<unsigned>(phase) << 8;
+                for (uint16_t i = 0; i < count; ++i, hue += hueStep) {
+                    const Pixel wheel = hue8(static_cast<uint8_t>(hue >> 8));
+                    const Pixel px{scale8(wheel.r, fx.colour.r),
+                                   scale8(wheel.g, fx.colour.g),
+                                   scale8(wheel.b, fx.colour.b)};
+                    blendInto(range[i], px, fx.blend);
+                }
+                break;
+            }
+
+            case LedEffectType::EyeLook: {
+                // Pupil centre and half-width in Q8 pixels; antialiased edges
+                const int32_t spanQ8 = (count - 1) << 7;              // half the range
+                const int32_t centreQ8 = spanQ8 + (x * spanQ8) / Constants::MAX_JOYSTICK_VALUE;
+                int32_t halfQ8 = std::max<int32_t>(fx.width, 1) << 7;
+                if (y > 0) halfQ8 -= (halfQ8 * y) / (2 * Constants::MAX_JOYSTICK_VALUE);
+                halfQ8 = std::max<int32_t>(halfQ8, 128);
+                for (uint16_t i = 0; i < count; ++i) {
+                    const int32_t distance = std::abs((static_cast<int32_t>(i) << 8) - centreQ8);
+                    const uint8_t level = distance < halfQ8
+                        ? static_cast<uint8_t>(255 - (distance * 255) / halfQ8) : 0;
+                    blendInto(range[i], scalePixel(fx.colour, level), fx.blend);
+                }
+                break;
+            }
+        }
+    }
+}
@@ -0,0 +1,92 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include "LedTypes.hpp"
+
+// ─── Effect descriptors ─────────────────────────────────────────────────────
+//
+//  An effect animates a contiguous pixel range (normally a face segment)
+//  as a pure function of the render clock.  Effects are layered in the
+//  order they were added; each one either replaces its range or adds onto
+//  whatever the layers below (and the show() framebuffer) produced.
+//
+enum class LedEffectType : uint8_t {
+    Solid,      // constant colour
+    Breathe,    // colour eased in and out over periodMs
+    Chase,      // head of `width` px with a fading tail, one lap per periodMs
+    Rainbow,    // hue wheel across the range, one rotation per periodMs
+    Blink,      // colour for duty/256 of each period, dark otherwise
+    EyeLook,    // pupil of `width` px positioned by the look target
+};
+
+enum class LedBlend : uint8_t {
+    Replace,    // overwrite the range
+    Add,        // saturating add onto the range
+};
+
+struct LedEffect {
+    LedEffectType type  = LedEffectType::Solid;
+    LedBlend      blend = LedBlend::Replace;
+    uint16_t start    = 0;
+    uint16_t count    = 0;              // 0 → to the end of the strip
+    Pixel    colour   {255, 255, 255};  // tint; Rainbow multiplies the hue by it
+    uint16_t periodMs = 1000;
+    uint8_t  width    = 3;              // Chase tail / EyeLook pupil, in pixels
+    uint8_t  duty     = 128;            // Blink on-time out of 256
+};
+
+// ─── Effect engine ──────────────────────────────────────────────────────────
+//
+//  Fixed table of MAX_EFFECTS slots evaluated once per frame on the LED
+//  render thread.  All maths is 8-bit / Q8 fixed point and render() never
+//  allocates, so its cost is bounded by MAX_EFFECTS × strip length.
+//
+//  Table edits reach the render thread through the same triple buffer as
+//  LedController::show(): writers copy the edited table into their slot
+//  and swap it into the middle; render() swaps out the newest one.  Edits
+//  are serialised by a mutex that render() never takes, so a writer can
+//  never stall a frame.
+//
+class LedEffectEngine {
+public:
+    static constexpr size_t MAX_EFFECTS = 8;
+
+    /// Add an effect on top of the existing ones.  Returns its id, or -1
+    /// if the table is full.
+    int add(const LedEffect& effect);
+    bool remove(int id);
+    void clear();
+    bool empty() const { return activeCount.load(std::memory_order_relaxed) == 0; }
+
+    /// Look target for EyeLook effects, as raw joystick axes
+    /// (±MAX_JOYSTICK_VALUE): x slides the pupil, y > 0 narrows it (squint).
+    void setLook(int16_t x, int16_t y);
+
+    /// Evaluate every active effect into frame[0..pixelCount) at nowMs.
+    /// Render thread only; lock-free.
+    void render(Pixel* frame, uint16_t pixelCount, uint32_t nowMs);
+
+private:
+    struct EffectTable {
+        std::array<LedEffect, MAX_EFFECTS> effects{};
+        std::array<bool, MAX_EFFECTS> used{};
+    };
+
+    std::mutex editMutex;                       // serialises writers; never taken by render()
+    EffectTable editing;                        // authoritative table (writers)
+
+    static constexpr uint8_t TABLE_INDEX_MASK = 0x03;
+    static constexpr uint8_t TABLE_FRESH = 0x04;
+    std::array<EffectTable, 3> tables{};
+    uint8_t writeTable = 0;                     // writers, under editMutex
+    uint8_t readTable = 1;                      // render thread
+    std::atomic<uint8_t> middleTable{2};
+
+    std::atomic<size_t> activeCount{0};
+    std::atomic<uint32_t> look{0};              // x in the low half, y in the high half
+
+    void publishLocked();
+};
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+// ─── Pixel representation ───────────────────────────────────────────────────
+struct Pixel {
+    uint8_t r = 0;
+    uint8_t g = 0;
+    uint8_t b = 0;
+};
+
+// ─── Named face-segment descriptor ─────────────────────────────────────────
+//
+//  Each segment is a contiguous run of pixels on the strip that maps to a
+//  logical region of the robot's face (e.g. "left eye", "mouth").
+//
+//  Segments are loaded at startup from a map file (LedController::
+//  loadSegments) and interned to dense LedSegmentIds, so the hot paths index
+//  a flat table instead of comparing names.
+//
+struct LedSegment {
+    std::string name;   // human-readable label  ("left_eye", "mouth", …)
+    uint16_t    start;  // first pixel index (0-based)
+    uint16_t    count;  // number of pixels in this segment
+};
+
+/// Dense index into the loaded segment table, in file order.
+enum class LedSegmentId : uint16_t { Invalid = 0xFFFF };
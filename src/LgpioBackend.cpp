@@ -0,0 +1,108 @@
+#include "LgpioBackend.hpp"
+#include <cerrno>
+#include <ctime>
+#include <iostream>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+    constexpr uint64_t NS_PER_SEC = 1000000000ULL;
+}
+
+LgpioBackend::LgpioBackend(int chip)
+    : chip(chip)
+{
+}
+
+LgpioBackend::~LgpioBackend() {
+    close();
+}
+
+bool LgpioBackend::open() {
+    handle = lgGpiochipOpen(chip);
+    if (handle < 0) {
+        std::cerr << "lgpio initialisation failed (chip " << chip << ")" << '\n';
+        return false;
+    }
+    return true;
+}
+
+void LgpioBackend::close() {
+    if (handle >= 0) {
+        lgGpiochipClose(handle);
+        handle = -1;
+    }
+}
+
+bool LgpioBackend::claimOutput(unsigned gpio, int level) {
+    return lgGpioClaimOutput(handle, 0, gpio, level) >= 0;
+}
+
+void LgpioBackend::write(unsigned gpio, int level) {
+    lgGpioWrite(handle, gpio, level);
+}
+
+bool LgpioBackend::claimGroup(const std::vector<int>& gpios, const std::vector<int>& levels) {
+    int rc = lgGroupClaimOutput(handle, 0, static_cast<int>(gpios.size()), gpios.data(), levels.data());
+    if (rc < 0) {
+        std::cerr << "lgGroupClaimOutput failed: " << lguErrorText(rc) << '\n';
+        return false;
+    }
+    groupLeader = gpios.front();
+    return true;
+}
+
+void LgpioBackend::groupWrite(uint64_t bits, uint64_t mask) {
+    lgGroupWrite(handle, groupLeader, bits, mask);
+}
+
+bool LgpioBackend::submitWave(const GpioPulse* pulses, size_t count) {
+    wave.resize(count);
+    for (size_t i = 0; i < count; ++i) {
+        wave[i] = {pulses[i].bits, pulses[i].mask, static_cast<int64_t>(pulses[i].delayUs)};
+    }
+    int rc = lgTxWave(handle, groupLeader, static_cast<int>(count), wave.data());
+    if (rc < 0) {
+        std::cerr << "lgTxWave failed: " << lguErrorText(rc) << '\n';
+        return false;
+    }
+    return true;
+}
+
+int LgpioBackend::waveRoom() {
+    return lgTxRoom(handle, groupLeader, LG_TX_WAVE);
+}
+
+bool LgpioBackend::waveBusy() {
+    return lgTxBusy(handle, groupLeader, LG_TX_WAVE) > 0;
+}
+
+uint64_t LgpioBackend::nowNs() {
+    timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * NS_PER_SEC + ts.tv_nsec;
+}
+
+// A futex wait with an absolute CLOCK_MONOTONIC timeout (FUTEX_WAIT_BITSET)
+// times out on the same hrtimer as clock_nanosleep(TIMER_ABSTIME), but
+// wake() can end it early.
+void LgpioBackend::sleepUntilNs(uint64_t deadlineNs) {
+    if (wakePending.exchange(0, std::memory_order_acquire) != 0) return;
+
+    timespec ts;
+    ts.tv_sec = static_cast<time_t>(deadlineNs / NS_PER_SEC);
+    ts.tv_nsec = static_cast<long>(deadlineNs % NS_PER_SEC);
+    while (syscall(SYS_futex, reinterpret_cast<uint32_t*>(&wakePending),
+                   FUTEX_WAIT_BITSET | FUTEX_PRIVATE_FLAG, 0, &ts, nullptr,
+                   FUTEX_BITSET_MATCH_ANY) < 0 && errno == EINTR) {
+    }
+    wakePending.store(0, std::memory_order_relaxed);
+}
+
+void LgpioBackend::wake() {
+    if (wakePending.exchange(1, std::memory_order_release) == 0) {
+        syscall(SYS_futex, reinterpret_cast<uint32_t*>(&wakePending),
+                FUTEX_WAKE | FUTEX_PRIVATE_FLAG, 1, nullptr, nullptr, 0);
+    }
+}
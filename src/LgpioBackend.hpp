@@ -0,0 +1,36 @@
+#pragma once
+#include <atomic>
+#include <vector>
+#include <lgpio.h>
+#include "GpioBackend.hpp"
+
+// GpioBackend on the Pi header through lgpio, timed by CLOCK_MONOTONIC.
+class LgpioBackend : public GpioBackend {
+public:
+    explicit LgpioBackend(int chip = 4);    // chip 4 is the Pi 5 header
+    ~LgpioBackend() override;
+
+    bool open() override;
+    void close() override;
+
+    bool claimOutput(unsigned gpio, int level) override;
+    void write(unsigned gpio, int level) override;
+
+    bool claimGroup(const std::vector<int>& gpios, const std::vector<int>& levels) override;
+    void groupWrite(uint64_t bits, uint64_t mask) override;
+
+    bool submitWave(const GpioPulse* pulses, size_t count) override;
+    int waveRoom() override;
+    bool waveBusy() override;
+
+    uint64_t nowNs() override;
+    void sleepUntilNs(uint64_t deadlineNs) override;
+    void wake() override;
+
+private:
+    int chip;
+    int handle = -1;
+    int groupLeader = -1;
+    std::vector<lgPulse_t> wave;            // conversion buffer, reused per submit
+    std::atomic<uint32_t> wakePending{0};   // futex word: 1 = wake() since the last sleep
+};
@@ -0,0 +1,114 @@
+#include "LinkQuality.hpp"
+#include <cstdlib>
+#include "Constants.hpp"
+
+static constexpr float LOSS_GAIN = 1.0f / 32.0f;
+static constexpr float DELAY_GAIN = 1.0f / 8.0f;
+static constexpr float JITTER_GAIN = 1.0f / 16.0f;         // RFC 3550 §6.4.1
+
+// A sequence this far behind the newest one is a restarted sender, not a
+// straggler from the network.
+static constexpr int32_t RESTART_SEQUENCE_GAP = 1024;
+
+LinkQuality::Verdict LinkQuality::onPacket(uint32_t sequence, bool hasTimestamp,
+                                           uint32_t sentUs, uint64_t arrivalUs) {
+    const int32_t gap = static_cast<int32_t>(sequence - lastSequence);
+    const bool restarted = !started ||
+                           arrivalUs - lastArrivalUs > Constants::UDP_SENDER_RESTART_MS * 1000ull ||
+                           gap < -RESTART_SEQUENCE_GAP;
+
+    if (restarted) {
+        // New or restarted sender: its clock and sequence start over
+        started = true;
+        haveTransit = false;
+        staleRun = 0;
+    } else if (gap <= 0) {
+        reorderedCount.fetch_add(1, std::memory_order_relaxed);
+        return Verdict::Reordered;
+    }
+
+    // Wrapping difference: a constant clock offset plus the one-way delay
+    const uint32_t transitUs = static_cast<uint32_t>(arrivalUs) - sentUs;
+    if (hasTimestamp && haveTransit) {
+        const int32_t delayUs = static_cast<int32_t>(transitUs - baselineUs);
+        if (delayUs > static_cast<int32_t>(Constants::UDP_STALE_PACKET_MS * 1000)) {
+            if (++staleRun < Constants::UDP_STALE_REBASELINE_PACKETS) {
+                // Still advance the sequence: anything older is staler still
+                staleCount.fetch_add(1, std::memory_order_relaxed);
+                lastSequence = sequence;
+                lastArrivalUs = arrivalUs;
+                trackMinimum(transitUs, arrivalUs);
+                return Verdict::Stale;
+            }
+            // Too many in a row to be a queue: this is the new zero delay
+            haveTransit = false;
+        }
+    }
+    staleRun = 0;
+
+    // Every sequence number skipped over counts as lost
+    const uint32_t missed = restarted ? 0 : static_cast<uint32_t>(gap) - 1;
+    if (missed > 0) {
+        lostCount.fetch_add(missed, std::memory_order_relaxed);
+    }
+    for (uint32_t i = 0; i < missed && i < 64; ++i) {
+        lossEwma += LOSS_GAIN * (1.0f - lossEwma);
+    }
+    lossEwma -= LOSS_GAIN * lossEwma;
+    lossRate.store(lossEwma, std::memory_order_relaxed);
+
+    lastSequence = sequence;
+    lastArrivalUs = arrivalUs;
+    if (hasTimestamp) {
+        updateTiming(transitUs, arrivalUs);
+    }
+
+    receivedCount.fetch_add(1, std::memory_order_relaxed);
+    return Verdict::Accept;
+}
+
+void LinkQuality::trackMinimum(uint32_t transitUs, uint64_t arrivalUs) {
+    // Windowed minimum: the baseline is the smaller of this window's and
+    // the previous window's best, so drift is forgotten within two windows
+    if (arrivalUs - windowStartUs > Constants::UDP_DELAY_WINDOW_MS * 1000ull) {
+        baselineUs = windowMinUs;
+        windowMinUs = transitUs;
+        windowStartUs = arrivalUs;
+    }
+    if (static_cast<int32_t>(transitUs - windowMinUs) < 0) windowMinUs = transitUs;
+    if (static_cast<int32_t>(transitUs - baselineUs) < 0) baselineUs = transitUs;
+}
+
+void LinkQuality::updateTiming(uint32_t transitUs, uint64_t arrivalUs) {
+    if (!haveTransit) {
+        haveTransit = true;
+        lastTransitUs = transitUs;
+        baselineUs = windowMinUs = transitUs;
+        windowStartUs = arrivalUs;
+        delayEwmaUs = jitterUs = 0.0f;
+    }
+
+    trackMinimum(transitUs, arrivalUs);
+
+    const float delayUs = static_cast<float>(static_cast<int32_t>(transitUs - baselineUs));
+    delayEwmaUs += DELAY_GAIN * (delayUs - delayEwmaUs);
+
+    const float deltaUs = static_cast<float>(std::abs(static_cast<int32_t>(transitUs - lastTransitUs)));
+    jitterUs += JITTER_GAIN * (deltaUs - jitterUs);
+    lastTransitUs = transitUs;
+
+    delayMs.store(delayEwmaUs / 1000.0f, std::memory_order_relaxed);
+    jitterMs.store(jitterUs / 1000.0f, std::memory_order_relaxed);
+}
+
+LinkStats LinkQuality::snapshot() const {
+    LinkStats stats;
+    stats.received  = receivedCount.load(std::memory_order_relaxed);
+    stats.lost      = lostCount.load(std::memory_order_relaxed);
+    stats.reordered = reorderedCount.load(std::memory_order_relaxed);
+    stats.stale     = staleCount.load(std::memory_order_relaxed);
+    stats.lossRate  = lossRate.load(std::memory_order_relaxed);
+    stats.delayMs   = delayMs.load(std::memory_order_relaxed);
+    stats.jitterMs  = jitterMs.load(std::memory_order_relaxed);
+    return stats;
+}
@@ -0,0 +1,72 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+// Link statistics for the UDP control stream, as seen by the control loop.
+struct LinkStats {
+    uint64_t received = 0;      // packets accepted
+    uint64_t lost = 0;          // sequence numbers never seen
+    uint64_t reordered = 0;     // duplicates and packets older than the newest
+    uint64_t stale = 0;         // in order, but delayed past UDP_STALE_PACKET_MS
+    float lossRate = 0.0f;      // recent fraction lost (EWMA over ~32 packets)
+    float delayMs = 0.0f;       // one-way delay above the best recent packet
+    float jitterMs = 0.0f;      // RFC 3550 interarrival jitter
+};
+
+// ─── Link quality tracker ───────────────────────────────────────────────────
+//
+//  Orders and ages the control packets of one sender.  A packet is accepted
+//  only if its sequence number is newer than every packet accepted so far,
+//  and – when it carries a sender timestamp – it is not stale.
+//
+//  Sender and receiver clocks are not synchronised, so the one-way delay is
+//  measured relative to the smallest transit time (arrival − sent) seen in
+//  the last one to two UDP_DELAY_WINDOW_MS windows: the best recent packet
+//  counts as zero delay, and clock drift ages out with the window.  Stale
+//  packets feed that minimum too, and a run of UDP_STALE_REBASELINE_PACKETS
+//  of them re-baselines at once: a lasting step in transit (the sender's
+//  clock stepping back, a new route) otherwise looks like every packet
+//  being late.
+//
+//  onPacket() is called from the receiving thread only; snapshot() may be
+//  called from any thread.
+//
+class LinkQuality {
+public:
+    enum class Verdict { Accept, Reordered, Stale };
+
+    Verdict onPacket(uint32_t sequence, bool hasTimestamp, uint32_t sentUs, uint64_t arrivalUs);
+
+    LinkStats snapshot() const;
+
+    /// Treat the next packet as coming from a new sender.  Statistics
+    /// carry on accumulating.  Receiving thread only.
+    void restart() { started = false; }
+
+private:
+    // Receiving thread only
+    bool started = false;
+    uint32_t lastSequence = 0;
+    uint64_t lastArrivalUs = 0;
+    bool haveTransit = false;
+    uint32_t lastTransitUs = 0;
+    uint32_t baselineUs = 0;        // min transit over the previous window
+    uint32_t windowMinUs = 0;       // min transit in the current window
+    uint64_t windowStartUs = 0;
+    uint32_t staleRun = 0;          // consecutive stale packets
+    float lossEwma = 0.0f;
+    float delayEwmaUs = 0.0f;
+    float jitterUs = 0.0f;
+
+    // Published for snapshot()
+    std::atomic<uint64_t> receivedCount{0};
+    std::atomic<uint64_t> lostCount{0};
+    std::atomic<uint64_t> reorderedCount{0};
+    std::atomic<uint64_t> staleCount{0};
+    std::atomic<float> lossRate{0.0f};
+    std::atomic<float> delayMs{0.0f};
+    std::atomic<float> jitterMs{0.0f};
+
+    void trackMinimum(uint32_t transitUs, uint64_t arrivalUs);
+    void updateTiming(uint32_t transitUs, uint64_t arrivalUs);
+};
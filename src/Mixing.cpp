@@ -0,0 +1,43 @@
+#include "Mixing.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+
+int clamp(int value, int minValue, int maxValue) {
+    return std::max(minValue, std::min(value, maxValue));
+}
+
+int scaleAxis(int16_t raw) {
+    double normalized = static_cast<double>(raw) / Constants::MAX_JOYSTICK_VALUE;
+    int scaled = static_cast<int>(std::lround(normalized * 512.0));
+    return clamp(scaled, -512, 512);
+}
+
+int16_t commandToSpeed(int command) {
+    if (std::abs(command) < Constants::JOYSTICK_DEADZONE) {
+        return 0;
+    }
+    long scaled = static_cast<long>(command) * Constants::MAX_SPEED_STEPS_PER_SEC;
+    scaled /= 512;
+    return static_cast<int16_t>(scaled);
+}
+
+MotorSpeeds mixAxes(int16_t x, int16_t y, int16_t rx, int16_t ry) {
+    int xScaled = -scaleAxis(x);
+    int yScaled = -scaleAxis(y);
+    int rxScaled = scaleAxis(rx);
+    int ryScaled = -scaleAxis(ry);
+
+    // Deadzone
+    int xCommandRaw = (std::abs(xScaled) < Constants::JOYSTICK_DEADZONE) ? 0 : xScaled;
+    int yCommandRaw = (std::abs(yScaled) < Constants::JOYSTICK_DEADZONE) ? 0 : yScaled;
+    int panCommand = (std::abs(rxScaled) < Constants::JOYSTICK_DEADZONE) ? 0 : rxScaled;
+    int tiltCommand = (std::abs(ryScaled) < Constants::JOYSTICK_DEADZONE) ? 0 : ryScaled;
+
+    // Mixing (X = forward/backward, Y = turning)
+    int leftMixCommand = clamp(xCommandRaw + yCommandRaw, -512, 512);
+    int rightMixCommand = clamp(xCommandRaw - yCommandRaw, -512, 512);
+
+    return {commandToSpeed(leftMixCommand), commandToSpeed(rightMixCommand),
+            commandToSpeed(panCommand), commandToSpeed(tiltCommand)};
+}
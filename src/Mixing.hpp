@@ -0,0 +1,23 @@
+#pragma once
+#include <cstdint>
+#include "Constants.hpp"
+
+// Step rates for all four axes derived from one set of stick readings.
+struct MotorSpeeds {
+    int16_t left;
+    int16_t right;
+    int16_t pan;
+    int16_t tilt;
+};
+
+int clamp(int value, int minValue, int maxValue);
+
+/// Raw joystick axis (±MAX_JOYSTICK_VALUE) → command in ±512.
+int scaleAxis(int16_t raw);
+
+/// Command in ±512 → steps/s, zero inside the deadzone.
+int16_t commandToSpeed(int command);
+
+/// Deadzone, differential-drive mix (X = forward/backward, Y = turning)
+/// and speed scaling for the left stick (drive) and right stick (turret).
+MotorSpeeds mixAxes(int16_t x, int16_t y, int16_t rx, int16_t ry);
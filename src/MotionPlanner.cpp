@@ -0,0 +1,104 @@
+#include "MotionPlanner.hpp"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+    constexpr double NS_PER_SEC = 1e9;
+    constexpr size_t MAX_RAMP_STEPS = 65535;    // bounds table memory for silly limits
+    constexpr double SCURVE_DT_SEC = 10e-6;     // integration step for jerk-limited ramps
+}
+
+MotionPlanner::MotionPlanner(const AxisLimits& limits) {
+    configure(limits);
+}
+
+void MotionPlanner::configure(const AxisLimits& limits) {
+    axisLimits = limits;
+    table.clear();
+    if (limits.maxVelocity == 0 || limits.acceleration == 0) {
+        return;
+    }
+
+    if (limits.jerk == 0) {
+        buildTrapezoidal();
+    } else {
+        buildSCurve();
+    }
+
+    // Always end on exactly the cruise interval
+    const uint32_t cruiseNs = static_cast<uint32_t>(NS_PER_SEC / limits.maxVelocity);
+    if (table.empty() || table.back() > cruiseNs) {
+        table.push_back(cruiseNs);
+    } else {
+        table.back() = cruiseNs;
+    }
+}
+
+uint32_t MotionPlanner::intervalNs(size_t rampStep) const {
+    if (table.empty()) return 0;
+    return table[std::min(rampStep, table.size() - 1)];
+}
+
+size_t MotionPlanner::rampStepsFor(uint32_t speed) const {
+    if (speed == 0 || table.empty()) return 0;
+    const uint32_t wantedNs = static_cast<uint32_t>(NS_PER_SEC / speed);
+
+    // Table is strictly decreasing: find the first interval at or below the
+    // wanted one.  Callers cap the cruise interval at wantedNs themselves.
+    auto it = std::lower_bound(table.begin(), table.end(), wantedNs,
+                               [](uint32_t entry, uint32_t wanted) { return entry > wanted; });
+    if (it == table.end()) return table.size();
+    return static_cast<size_t>(it - table.begin()) + 1;
+}
+
+// ─── Trapezoidal ramp (AVR446) ──────────────────────────────────────────────
+//
+//  c0 = 0.676 · sqrt(2 / a)               (0.676 corrects the first step)
+//  cn = c(n-1) − 2·c(n-1) / (4n + 1)
+//
+void MotionPlanner::buildTrapezoidal() {
+    const double cruiseNs = NS_PER_SEC / axisLimits.maxVelocity;
+    double c = 0.676 * std::sqrt(2.0 / axisLimits.acceleration) * NS_PER_SEC;
+
+    for (size_t n = 1; c > cruiseNs && table.size() < MAX_RAMP_STEPS; ++n) {
+        table.push_back(static_cast<uint32_t>(c));
+        c -= (2.0 * c) / (4.0 * n + 1.0);
+    }
+}
+
+// ─── Jerk-limited S-curve ramp ──────────────────────────────────────────────
+//
+//  No closed form per step, so integrate the profile numerically: jerk the
+//  acceleration up to its limit, hold it, then jerk it back down early
+//  enough (a² / 2j before cruise) to land on maxVelocity with zero
+//  acceleration.  Each integer position crossing becomes one table entry.
+//
+void MotionPlanner::buildSCurve() {
+    const double vMax = axisLimits.maxVelocity;
+    const double aMax = axisLimits.acceleration;
+    const double jerk = axisLimits.jerk;
+
+    double t = 0.0, pos = 0.0, vel = 0.0, acc = 0.0;
+    double lastStepT = 0.0;
+    double nextStep = 1.0;
+
+    while (vel < vMax && table.size() < MAX_RAMP_STEPS) {
+        const bool easeOut = (vMax - vel) <= (acc * acc) / (2.0 * jerk);
+        acc = easeOut ? std::max(acc - jerk * SCURVE_DT_SEC, aMax * 1e-3)
+                      : std::min(acc + jerk * SCURVE_DT_SEC, aMax);
+        vel = std::min(vel + acc * SCURVE_DT_SEC, vMax);
+        pos += vel * SCURVE_DT_SEC;
+        t += SCURVE_DT_SEC;
+
+        while (pos >= nextStep) {
+            // Interpolate the crossing inside this dt and keep the table
+            // monotonic so lookups can binary-search it.
+            const double stepT = t - (pos - nextStep) / vel;
+            uint32_t intervalNs = static_cast<uint32_t>((stepT - lastStepT) * NS_PER_SEC);
+            if (!table.empty()) intervalNs = std::min(intervalNs, table.back());
+            table.push_back(intervalNs);
+            lastStepT = stepT;
+            nextStep += 1.0;
+        }
+    }
+}
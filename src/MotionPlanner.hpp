@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// ─── Per-axis motion limits ─────────────────────────────────────────────────
+//
+//  All values are in steps.  jerk == 0 selects a trapezoidal (constant
+//  acceleration) ramp; any other value produces a jerk-limited S-curve.
+//
+struct AxisLimits {
+    uint32_t maxVelocity;   // steps/s
+    uint32_t acceleration;  // steps/s²
+    uint32_t jerk;          // steps/s³ (0 = trapezoidal)
+};
+
+// ─── Motion Planner ─────────────────────────────────────────────────────────
+//
+//  Precomputes the step-interval table for accelerating one axis from rest
+//  to its maximum velocity, in the style of the AVR446 / Leib ramp:
+//
+//      interval(n) = time between ramp step n and ramp step n + 1
+//
+//  Deceleration walks the same table backwards, so the step loop only ever
+//  does an index increment/decrement and a table lookup per step.
+//
+class MotionPlanner {
+public:
+    MotionPlanner() = default;
+    explicit MotionPlanner(const AxisLimits& limits);
+
+    /// Rebuild the ramp table for new limits (allocates; call at startup).
+    void configure(const AxisLimits& limits);
+    const AxisLimits& limits() const { return axisLimits; }
+
+    /// Number of ramp steps needed to reach maxVelocity.
+    size_t rampLength() const { return table.size(); }
+
+    /// Interval in ns following ramp step n (clamped to the last entry).
+    uint32_t intervalNs(size_t rampStep) const;
+
+    /// Ramp position whose interval first reaches the requested speed
+    /// (steps/s), i.e. how many ramp steps it takes to get there.
+    size_t rampStepsFor(uint32_t speed) const;
+
+private:
+    AxisLimits axisLimits{};
+    std::vector<uint32_t> table;
+
+    void buildTrapezoidal();
+    void buildSCurve();
+};
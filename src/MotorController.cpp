@@ -1,155 +1,676 @@
 #include "MotorController.hpp"
-#include <lgpio.h>
 #include <iostream>
 #include <cmath>
-#include <chrono>
+#include <algorithm>
+#include <sys/prctl.h>
+
+namespace {
+    constexpr uint64_t NS_PER_US = 1000ULL;
+    constexpr uint64_t NS_PER_SEC = 1000000000ULL;
+
+    // std::push_heap builds a max-heap; invert the comparison for earliest-first.
+    bool laterDeadline(const StepEvent& a, const StepEvent& b) {
+        return a.deadlineNs > b.deadlineNs;
+    }
+}
+
+MotorController::MotorController(std::unique_ptr<GpioBackend> backend)
+    : gpio(std::move(backend))
+{
+    const AxisLimits driveLimits{Constants::DRIVE_MAX_VELOCITY, Constants::DRIVE_ACCELERATION, Constants::DRIVE_JERK};
+    const AxisLimits turretLimits{Constants::TURRET_MAX_VELOCITY, Constants::TURRET_ACCELERATION, Constants::TURRET_JERK};
 
-MotorController::MotorController() {
     // Initialize motor states
-    motors.push_back(new MotorState{{Constants::MOTOR_LEFT_ENABLE, Constants::MOTOR_LEFT_DIRECTION, Constants::MOTOR_LEFT_PULSE}});
-    motors.push_back(new MotorState{{Constants::MOTOR_RIGHT_ENABLE, Constants::MOTOR_RIGHT_DIRECTION, Constants::MOTOR_RIGHT_PULSE}});
-    motors.push_back(new MotorState{{Constants::MOTOR_PAN_ENABLE, Constants::MOTOR_PAN_DIRECTION, Constants::MOTOR_PAN_PULSE}});
-    motors.push_back(new MotorState{{Constants::MOTOR_TILT_ENABLE, Constants::MOTOR_TILT_DIRECTION, Constants::MOTOR_TILT_PULSE}});
+    motors.push_back(new MotorState{{Constants::MOTOR_LEFT_ENABLE, Constants::MOTOR_LEFT_DIRECTION, Constants::MOTOR_LEFT_PULSE}, MotionPlanner(driveLimits)});
+    motors.push_back(new MotorState{{Constants::MOTOR_RIGHT_ENABLE, Constants::MOTOR_RIGHT_DIRECTION, Constants::MOTOR_RIGHT_PULSE}, MotionPlanner(driveLimits)});
+    motors.push_back(new MotorState{{Constants::MOTOR_PAN_ENABLE, Constants::MOTOR_PAN_DIRECTION, Constants::MOTOR_PAN_PULSE}, MotionPlanner(turretLimits)});
+    motors.push_back(new MotorState{{Constants::MOTOR_TILT_ENABLE, Constants::MOTOR_TILT_DIRECTION, Constants::MOTOR_TILT_PULSE}, MotionPlanner(turretLimits)});
+
+    // Worst case: one rising and one falling edge in flight per motor
+    // (a faster target moves the queued rising edge in place rather than
+    // queueing another), plus the coordinated move's step event and one
+    // stale one left behind by a cancel before its first step
+    eventQueue.reserve(motors.size() * 2 + 2);
+    loggedStats.resize(motors.size());
 }
 
 MotorController::~MotorController() {
     stop();
     for (auto m : motors) delete m;
-    if (hGpio >= 0) lgGpiochipClose(hGpio);
+    gpio->close();
+}
+
+void MotorController::setPulseMode(PulseMode mode) {
+    pulseMode = mode;
+}
+
+void MotorController::setRealtimeConfig(const RealtimeConfig& config) {
+    realtimeConfig = config;
+}
+
+void MotorController::setAxisLimits(int motorIndex, const AxisLimits& limits) {
+    if (motorIndex >= 0 && motorIndex < static_cast<int>(motors.size())) {
+        motors[motorIndex]->planner.configure(limits);
+    }
 }
 
 bool MotorController::initialize() {
-    // Open GPIO chip 4 (standard for Pi 5 header)
-    hGpio = lgGpiochipOpen(4);
-    if (hGpio < 0) {
-        std::cerr << "lgpio initialisation failed (chip 4)" << '\n';
+    if (!gpio->open()) {
         return false;
     }
 
     if (Constants::LED_GPIO >= 0) {
-        lgGpioClaimOutput(hGpio, 0, Constants::LED_GPIO, 0);
+        gpio->claimOutput(Constants::LED_GPIO, 0);
     }
 
-    for (auto motor : motors) {
-        ensurePinSetup(motor->pins);
-        workers.emplace_back(&MotorController::worker, this, motor);
+    if (pulseMode == PulseMode::PulseTrain && !claimPulseTrainGroup()) {
+        std::cerr << "Pulse-train group claim failed, falling back to direct pulses" << '\n';
+        pulseMode = PulseMode::Direct;
+    }
+
+    if (pulseMode == PulseMode::Direct) {
+        for (auto motor : motors) {
+            ensurePinSetup(motor->pins);
+        }
     }
+
+    // A single thread drives every axis from one timebase
+    scheduler = std::thread(&MotorController::schedulerLoop, this);
     return true;
 }
 
 void MotorController::stop() {
     running.store(false);
-    for (auto& t : workers) {
-        if (t.joinable()) t.join();
-    }
-    workers.clear();
+    gpio->wake();
+    if (scheduler.joinable()) scheduler.join();
 }
 
 void MotorController::setSpeed(int motorIndex, int16_t speed) {
-    if (motorIndex >= 0 && motorIndex < motors.size()) {
-        motors[motorIndex]->targetSpeed.store(speed, std::memory_order_relaxed);
+    if (motorIndex >= 0 && motorIndex < static_cast<int>(motors.size())) {
+        if (motors[motorIndex]->targetSpeed.exchange(speed, std::memory_order_relaxed) != speed) {
+            requestPoll();
+        }
     }
 }
 
+void MotorController::requestPoll() {
+    targetsChanged.store(true, std::memory_order_release);
+    gpio->wake();
+}
+
+void MotorController::moveRelative(double distanceMm, double headingRad) {
+    const double stepsPerMm = Constants::DRIVE_STEPS_PER_REV / (M_PI * Constants::DRIVE_WHEEL_DIAMETER_MM);
+    const double arcMm = headingRad * Constants::DRIVE_TRACK_WIDTH_MM / 2.0;
+    const int32_t leftSteps = static_cast<int32_t>(std::lround((distanceMm - arcMm) * stepsPerMm));
+    const int32_t rightSteps = static_cast<int32_t>(std::lround((distanceMm + arcMm) * stepsPerMm));
+
+    if (leftSteps == 0 && rightSteps == 0) return;
+
+    pendingMoveSteps.store((static_cast<uint64_t>(static_cast<uint32_t>(leftSteps)) << 32) |
+                               static_cast<uint32_t>(rightSteps),
+                           std::memory_order_relaxed);
+    moveCancel.store(false, std::memory_order_relaxed);
+    moveActive.store(true, std::memory_order_release);
+    movePending.store(true, std::memory_order_release);
+    requestPoll();
+}
+
+void MotorController::cancelMove() {
+    movePending.store(false, std::memory_order_relaxed);
+    moveCancel.store(true, std::memory_order_release);
+    requestPoll();
+}
+
 void MotorController::ensurePinSetup(const MotorPins& pins) {
-    lgGpioClaimOutput(hGpio, 0, pins.enable, Constants::ENABLE_ACTIVE_LEVEL);
-    lgGpioClaimOutput(hGpio, 0, pins.direction, 1);
-    lgGpioClaimOutput(hGpio, 0, pins.pulse, !Constants::PULSE_ACTIVE_LEVEL);
+    gpio->claimOutput(pins.enable, Constants::ENABLE_ACTIVE_LEVEL);
+    gpio->claimOutput(pins.direction, 1);
+    gpio->claimOutput(pins.pulse, !Constants::PULSE_ACTIVE_LEVEL);
+}
+
+bool MotorController::claimPulseTrainGroup() {
+    std::vector<int> levels;
+    groupPins.clear();
+    for (auto motor : motors) {
+        groupPins.push_back(static_cast<int>(motor->pins.enable));
+        levels.push_back(Constants::ENABLE_ACTIVE_LEVEL);
+        groupPins.push_back(static_cast<int>(motor->pins.direction));
+        levels.push_back(1);
+        groupPins.push_back(static_cast<int>(motor->pins.pulse));
+        levels.push_back(!Constants::PULSE_ACTIVE_LEVEL);
+    }
+
+    if (!gpio->claimGroup(groupPins, levels)) {
+        groupPins.clear();
+        return false;
+    }
+    return true;
 }
 
-uint32_t MotorController::tickDiff(uint32_t later, uint32_t earlier) {
-    return (later >= earlier) ? (later - earlier)
-                              : (0xFFFFFFFFu - earlier + 1u + later);
+// ─── Step scheduler ─────────────────────────────────────────────────────────
+//
+//  Every pending pulse edge for every motor lives in one min-heap keyed by
+//  its absolute deadline.  The thread sleeps (absolute deadline) until the
+//  earliest edge or the next target-speed poll, whichever comes first, so no
+//  core is ever spent spinning.  A new target cuts the sleep short, and with
+//  nothing in flight there is no poll at all: the thread sleeps until woken.
+//
+
+void MotorController::pushEvent(const StepEvent& event) {
+    eventQueue.push_back(event);
+    std::push_heap(eventQueue.begin(), eventQueue.end(), laterDeadline);
 }
 
-uint64_t MotorController::steadyClockMs() {
-    return std::chrono::duration_cast<std::chrono::milliseconds>(
-               std::chrono::steady_clock::now().time_since_epoch())
-        .count();
+void MotorController::popEvent() {
+    std::pop_heap(eventQueue.begin(), eventQueue.end(), laterDeadline);
+    eventQueue.pop_back();
 }
 
-void MotorController::worker(MotorState* motor) {
-    // Identify which motor this is for logging
-    int motorIndex = -1;
-    for (size_t i = 0; i < motors.size(); ++i) {
-        if (motors[i] == motor) { motorIndex = i; break; }
+void MotorController::schedulerLoop() {
+    RealTime::configureCurrentThread(realtimeConfig, "step-scheduler");
+
+    // Default timer slack (50 µs) would dominate the wake-up jitter
+    prctl(PR_SET_TIMERSLACK, 1UL);
+
+    if (pulseMode == PulseMode::PulseTrain) {
+        runPulseTrain();
+    } else {
+        runDirect();
     }
-    
-    auto getTick = []() { return (uint32_t)(lguTimestamp() / 1000); };
-    auto delayUs = [](uint32_t us) {
-        if (us > 100) lguSleep(us / 1e6);
-        else {
-            uint64_t end = lguTimestamp() + (uint64_t)us * 1000;
-            while (lguTimestamp() < end);
+
+    parkOutputs();
+    eventQueue.clear();
+}
+
+void MotorController::runDirect() {
+    const uint64_t pollNs = Constants::SCHEDULER_POLL_US * NS_PER_US;
+    uint64_t nextPollNs = gpio->nowNs();
+
+    while (running.load(std::memory_order_relaxed)) {
+        loopIterations.fetch_add(1, std::memory_order_relaxed);
+        uint64_t nowNs = gpio->nowNs();
+
+        const bool changed = targetsChanged.exchange(false, std::memory_order_acquire);
+        if (changed || nowNs >= nextPollNs) {
+            pollTargets(nowNs);
+            updateStepIndicator(nowNs);
+            nextPollNs = nowNs + pollNs;
+        }
+
+        while (!eventQueue.empty() && eventQueue.front().deadlineNs <= nowNs) {
+            StepEvent event = eventQueue.front();
+            popEvent();
+            fireEvent(event, nowNs);
         }
-    };
 
-    uint32_t lastStepTick = getTick();
-    int16_t lastLoggedSpeed = 0;
+        uint64_t wakeNs = nextPollNs;
+        if (eventQueue.empty()) {
+            // Nothing in flight: settle the outputs (disable, start a
+            // pending move), then sleep until setSpeed() or a move wakes
+            // us, or the step LED is due off.  Polling only runs while
+            // something is moving.
+            pollTargets(nowNs);
+            if (eventQueue.empty()) {
+                wakeNs = stepIndicatorOn ? stepIndicatorDeadlineNs
+                                         : nowNs + Constants::SCHEDULER_IDLE_MS * 1000 * NS_PER_US;
+            }
+        }
+        if (!eventQueue.empty()) {
+            wakeNs = std::min(wakeNs, eventQueue.front().deadlineNs);
+        }
+        gpio->sleepUntilNs(wakeNs);
+    }
+}
+
+// ─── Pulse-train emission ───────────────────────────────────────────────────
+//
+//  The same heap is replayed in virtual time one window ahead of the wall
+//  clock.  Every edge that falls inside [windowStart, windowEnd) is recorded
+//  as a group bit change and the whole window goes out as one wave; the
+//  next window is rendered while this one plays, so the wave queue never
+//  runs dry and user space never touches a pin between submissions.
+//
+
+void MotorController::runPulseTrain() {
+    const uint64_t windowNs = Constants::PULSE_TRAIN_WINDOW_MS * 1000 * NS_PER_US;
+    std::vector<GpioPulse> wave;
+    pulseTrain.reserve(motors.size() * 64);
+    wave.reserve(motors.size() * 64);
+
+    uint64_t windowStartNs = gpio->nowNs();
+
     while (running.load(std::memory_order_relaxed)) {
-        int16_t speed = motor->targetSpeed.load(std::memory_order_relaxed);
-        
+        loopIterations.fetch_add(1, std::memory_order_relaxed);
+        const uint64_t windowEndNs = windowStartNs + windowNs;
+        pulseTrain.clear();
+
+        // Targets are sampled once per window at its (virtual) start time
+        pollTargets(windowStartNs);
+        while (!eventQueue.empty() && eventQueue.front().deadlineNs < windowEndNs) {
+            StepEvent event = eventQueue.front();
+            popEvent();
+            fireEvent(event, event.deadlineNs);
+        }
+
+        // Convert absolute edge times into per-entry wave delays; the
+        // leading entry pads out to the first edge and the last one pads to
+        // the window end so consecutive waves tile the timeline exactly.
+        wave.clear();
+        uint64_t cursorUs = windowStartNs / NS_PER_US;
+        wave.push_back({0, 0, 0});
+        for (const auto& edge : pulseTrain) {
+            wave.back().delayUs = edge.timeUs - cursorUs;
+            wave.push_back({edge.bits, edge.mask, 0});
+            cursorUs = edge.timeUs;
+        }
+        wave.back().delayUs = windowEndNs / NS_PER_US - cursorUs;
+
+        while (running.load(std::memory_order_relaxed) && gpio->waveRoom() <= 0) {
+            gpio->sleepUntilNs(gpio->nowNs() + 1000 * NS_PER_US);
+        }
+        if (gpio->nowNs() > windowStartNs) {
+            // Previous window already finished: the wave queue ran dry
+            waveUnderruns.fetch_add(1, std::memory_order_relaxed);
+        }
+        gpio->submitWave(wave.data(), wave.size());
+
+        updateStepIndicator(gpio->nowNs());
+
+        // Render the following window once this one starts playing
+        while (running.load(std::memory_order_relaxed) && gpio->nowNs() < windowStartNs) {
+            gpio->sleepUntilNs(windowStartNs);
+        }
+        windowStartNs = windowEndNs;
+    }
+
+    // Let the queued windows drain before parking the pins.  Bounded by
+    // sleeps as well as by the clock: a simulated clock held at its
+    // horizon never reaches the deadline.
+    const uint64_t drainPollNs = 1000 * NS_PER_US;
+    const uint64_t drainDeadlineNs = gpio->nowNs() + 2 * windowNs;
+    for (uint64_t polls = 0; polls <= 2 * windowNs / drainPollNs; ++polls) {
+        if (!gpio->waveBusy() || gpio->nowNs() >= drainDeadlineNs) break;
+        gpio->sleepUntilNs(gpio->nowNs() + drainPollNs);
+    }
+}
+
+void MotorController::parkOutputs() {
+    pulseTrain.clear();
+    for (size_t i = 0; i < motors.size(); ++i) {
+        writeMotorPin(static_cast<int>(i), MotorPin::Pulse, !Constants::PULSE_ACTIVE_LEVEL, 0);
+        writeMotorPin(static_cast<int>(i), MotorPin::Enable, !Constants::ENABLE_ACTIVE_LEVEL, 0);
+    }
+    if (pulseMode == PulseMode::PulseTrain) {
+        gpio->groupWrite(pulseTrain.back().bits, pulseTrain.back().mask);
+        pulseTrain.clear();
+    }
+    if (Constants::LED_GPIO >= 0 && stepIndicatorOn) {
+        gpio->write(Constants::LED_GPIO, 0);
+        stepIndicatorOn = false;
+    }
+}
+
+void MotorController::writeMotorPin(int motorIndex, MotorPin pin, int level, uint64_t atNs) {
+    if (pulseMode == PulseMode::Direct) {
+        const MotorPins& pins = motors[motorIndex]->pins;
+        unsigned pinNumber = (pin == MotorPin::Enable) ? pins.enable
+                           : (pin == MotorPin::Direction) ? pins.direction
+                           : pins.pulse;
+        gpio->write(pinNumber, level);
+        return;
+    }
+
+    // Edges landing on the same microsecond collapse into one wave entry
+    const uint64_t bit = 1ULL << (motorIndex * 3 + static_cast<int>(pin));
+    const uint64_t timeUs = atNs / NS_PER_US;
+    if (pulseTrain.empty() || pulseTrain.back().timeUs != timeUs) {
+        pulseTrain.push_back({timeUs, 0, 0});
+    }
+    PulseTrainEdge& edge = pulseTrain.back();
+    edge.bits = level ? (edge.bits | bit) : (edge.bits & ~bit);
+    edge.mask |= bit;
+}
+
+void MotorController::pollTargets(uint64_t nowNs) {
+    updateCoordinatedMove(nowNs);
+    for (size_t i = 0; i < motors.size(); ++i) {
+        updateMotor(static_cast<int>(i), nowNs);
+    }
+}
+
+bool MotorController::ownedByMove(int motorIndex) const {
+    return (motorIndex == LEFT || motorIndex == RIGHT) &&
+           (move.active || movePending.load(std::memory_order_relaxed));
+}
+
+void MotorController::updateMotor(int motorIndex, uint64_t nowNs) {
+    MotorState* motor = motors[motorIndex];
+
+    // Wheels executing a coordinated move are stepped by fireMoveStep()
+    if (move.active && (motorIndex == LEFT || motorIndex == RIGHT)) return;
+
+    // A pending move brings the wheels to rest before it takes over
+    int16_t speed = ownedByMove(motorIndex) ? 0 : motor->targetSpeed.load(std::memory_order_relaxed);
+    uint32_t absSpeed = static_cast<uint32_t>(std::abs(speed));
+
+    // Publish the new target; the step loop walks the ramp towards it
+    if (speed != 0) motor->wantForward = (speed > 0);
+    motor->targetRampStep = motor->planner.rampStepsFor(absSpeed);
+    motor->cruiseIntervalNs = absSpeed ? NS_PER_SEC / absSpeed : 0;
+
+    if (motor->rampStep == 0 && !motor->stepQueued) {
+        // At rest: the only place enable and direction ever change
         if (speed == 0) {
             if (motor->enabled) {
-                lgGpioWrite(hGpio, motor->pins.enable, !Constants::ENABLE_ACTIVE_LEVEL);
+                writeMotorPin(motorIndex, MotorPin::Enable, !Constants::ENABLE_ACTIVE_LEVEL, nowNs);
                 motor->enabled = false;
             }
-            lguSleep(0.002);
-            continue;
+            return;
         }
 
+        // The driver latches ENA/DIR only after a setup time; the first
+        // step edge must not share their instant (or their wave entry)
+        uint64_t firstStepNs = nowNs;
         if (!motor->enabled) {
-            lgGpioWrite(hGpio, motor->pins.enable, Constants::ENABLE_ACTIVE_LEVEL);
+            writeMotorPin(motorIndex, MotorPin::Enable, Constants::ENABLE_ACTIVE_LEVEL, nowNs);
             motor->enabled = true;
+            firstStepNs = nowNs + Constants::DIR_SETUP_US * NS_PER_US;
+        }
+        if (motor->directionForward != motor->wantForward) {
+            writeMotorPin(motorIndex, MotorPin::Direction, motor->wantForward ? 1 : 0, nowNs);
+            motor->directionForward = motor->wantForward;
+            firstStepNs = nowNs + Constants::DIR_SETUP_US * NS_PER_US;
         }
 
-        bool forward = (speed > 0);
-        if (motor->directionForward != forward) {
-            lgGpioWrite(hGpio, motor->pins.direction, forward ? 1 : 0);
-            motor->directionForward = forward;
-            lastStepTick = getTick();
+        // Just ramped down (e.g. reversing): the rotor only counts as
+        // stopped once a start-speed interval has passed since its last step
+        firstStepNs = std::max(firstStepNs, motor->lastStepNs + motor->planner.intervalNs(0));
+
+        motor->generation++;
+        motor->stepIntervalNs = 0;
+        motor->stepQueued = true;
+        pushEvent({firstStepNs, motorIndex, true, motor->generation});
+        return;
+    }
+
+    // Moving: a faster target shortens the pending interval right away
+    // instead of waiting out a long low-speed step.  Below the current
+    // ramp position (slowing, stopping, reversing) the uncapped ramp entry
+    // would pull the step early, so only a target at or above it counts.
+    if (motor->stepQueued && motor->rampStep > 0 && motor->wantForward == motor->directionForward &&
+        motor->targetRampStep >= motor->rampStep) {
+        uint64_t intervalNs = plannedIntervalNs(*motor);
+        if (intervalNs < motor->stepIntervalNs) {
+            motor->stepIntervalNs = intervalNs;
+            advanceStep(motorIndex, std::max(motor->lastStepNs + intervalNs, nowNs));
         }
+    }
+}
 
-        uint16_t absSpeed = static_cast<uint16_t>(std::abs(speed));
-        unsigned long stepInterval = 1000000UL / absSpeed;
-        if (stepInterval <= Constants::PULSE_WIDTH_US) {
-            stepInterval = Constants::PULSE_WIDTH_US + 1;
+void MotorController::advanceStep(int motorIndex, uint64_t deadlineNs) {
+    // Move the queued rising edge earlier in place, so the heap never holds
+    // more than one per motor and never grows on the scheduler thread.
+    // Lowering a key only needs a sift-up, which push_heap does on the
+    // prefix ending at the entry.
+    const uint32_t generation = motors[motorIndex]->generation;
+    for (size_t i = 0; i < eventQueue.size(); ++i) {
+        StepEvent& event = eventQueue[i];
+        if (event.rising && event.motorIndex == motorIndex && event.generation == generation) {
+            if (deadlineNs < event.deadlineNs) {
+                event.deadlineNs = deadlineNs;
+                std::push_heap(eventQueue.begin(), eventQueue.begin() + i + 1, laterDeadline);
+            }
+            return;
         }
+    }
+}
 
-        uint32_t nowTick = getTick();
-        uint32_t elapsed = tickDiff(nowTick, lastStepTick);
-        if (elapsed >= stepInterval) {
-            lgGpioWrite(hGpio, motor->pins.pulse, Constants::PULSE_ACTIVE_LEVEL);
-            delayUs(Constants::PULSE_WIDTH_US);
-            lgGpioWrite(hGpio, motor->pins.pulse, !Constants::PULSE_ACTIVE_LEVEL);
-            lastStepTick = getTick();
+uint64_t MotorController::plannedIntervalNs(const MotorState& motor) {
+    uint64_t intervalNs = motor.planner.intervalNs(motor.rampStep - 1);
 
-            if (Constants::LED_GPIO >= 0) {
-                stepIndicatorDeadlineMs.store(steadyClockMs() + Constants::STEP_LED_DURATION_MS,
-                                              std::memory_order_relaxed);
-                if (!stepIndicatorOn.exchange(true, std::memory_order_relaxed)) {
-                    lgGpioWrite(hGpio, Constants::LED_GPIO, 1);
-                }
-            }
-            continue;
+    // Between table entries the commanded speed caps the cruise rate
+    if (motor.rampStep == motor.targetRampStep && motor.wantForward == motor.directionForward) {
+        intervalNs = std::max(intervalNs, motor.cruiseIntervalNs);
+    }
+    return std::max<uint64_t>(intervalNs, (Constants::PULSE_WIDTH_US + 1) * NS_PER_US);
+}
+
+void MotorController::fireEvent(const StepEvent& event, uint64_t nowNs) {
+    if (event.motorIndex == MOVE_EVENT) {
+        if (move.active && event.generation == move.generation) {
+            fireMoveStep(event, nowNs);
         }
+        return;
+    }
+
+    MotorState* motor = motors[event.motorIndex];
 
-        // Check LED turn off
-        if (Constants::LED_GPIO >= 0 && stepIndicatorOn.load(std::memory_order_relaxed)) {
-            uint64_t deadline = stepIndicatorDeadlineMs.load(std::memory_order_relaxed);
-            if (steadyClockMs() >= deadline) {
-                lgGpioWrite(hGpio, Constants::LED_GPIO, 0);
-                stepIndicatorOn.store(false, std::memory_order_relaxed);
+    if (!event.rising) {
+        writeMotorPin(event.motorIndex, MotorPin::Pulse, !Constants::PULSE_ACTIVE_LEVEL, nowNs);
+        recordStepFall(*motor, nowNs);
+        return;
+    }
+
+    if (event.generation != motor->generation) {
+        return;
+    }
+
+    writeMotorPin(event.motorIndex, MotorPin::Pulse, Constants::PULSE_ACTIVE_LEVEL, nowNs);
+    pushEvent({nowNs + Constants::PULSE_WIDTH_US * NS_PER_US, event.motorIndex, false, 0});
+    recordStepRise(*motor, event.deadlineNs, nowNs);
+
+    // One ramp step per motor step: towards the target, or back down to
+    // rest first when the commanded direction has flipped.
+    size_t targetRampStep = (motor->wantForward == motor->directionForward) ? motor->targetRampStep : 0;
+    if (motor->rampStep < targetRampStep) {
+        motor->rampStep++;
+    } else if (motor->rampStep > targetRampStep) {
+        motor->rampStep--;
+    }
+
+    if (motor->rampStep == 0) {
+        motor->stepQueued = false;
+        motor->lastStepNs = nowNs;
+    } else {
+        uint64_t intervalNs = plannedIntervalNs(*motor);
+
+        // Keep the cadence on the ideal grid, but re-anchor after a stall
+        // rather than bursting out the missed steps back to back.
+        motor->lastStepNs = (nowNs - event.deadlineNs > intervalNs) ? nowNs : event.deadlineNs;
+        motor->stepIntervalNs = intervalNs;
+        pushEvent({motor->lastStepNs + intervalNs, event.motorIndex, true, motor->generation});
+    }
+
+    flashStepIndicator(nowNs);
+}
+
+// ─── Coordinated differential-drive moves ───────────────────────────────────
+
+void MotorController::updateCoordinatedMove(uint64_t nowNs) {
+    if (moveCancel.exchange(false, std::memory_order_acquire)) {
+        if (move.active && move.rampStep > 0) {
+            // Shorten the move to exactly the steps needed to ramp down
+            move.majorSteps = std::min<uint32_t>(move.majorSteps,
+                                                 move.stepsDone + static_cast<uint32_t>(move.rampStep));
+        } else {
+            move.active = false;
+            move.generation++;
+            if (!movePending.load(std::memory_order_acquire)) {
+                moveActive.store(false, std::memory_order_release);
             }
         }
+    }
+
+    if (move.active || !movePending.load(std::memory_order_acquire)) return;
+
+    // Wait for both wheels to ramp down from joystick driving
+    for (int wheel : {LEFT, RIGHT}) {
+        if (motors[wheel]->rampStep != 0 || motors[wheel]->stepQueued) return;
+    }
+    // Raised before the pending flag drops, so isMoving() never sees a gap
+    // between a queued move and its start
+    moveActive.store(true, std::memory_order_release);
+    if (!movePending.exchange(false, std::memory_order_acquire)) return;
+
+    const uint64_t packed = pendingMoveSteps.load(std::memory_order_relaxed);
+    const int32_t wheelSteps[2] = {static_cast<int32_t>(packed >> 32),
+                                   static_cast<int32_t>(packed & 0xFFFFFFFFu)};
+
+    uint64_t firstStepNs = nowNs;
+    for (int wheel : {LEFT, RIGHT}) {
+        MotorState* motor = motors[wheel];
+        const bool forward = wheelSteps[wheel] >= 0;
+        if (!motor->enabled) {
+            writeMotorPin(wheel, MotorPin::Enable, Constants::ENABLE_ACTIVE_LEVEL, nowNs);
+            motor->enabled = true;
+            firstStepNs = nowNs + Constants::DIR_SETUP_US * NS_PER_US;
+        }
+        if (motor->directionForward != forward) {
+            writeMotorPin(wheel, MotorPin::Direction, forward ? 1 : 0, nowNs);
+            motor->directionForward = forward;
+            firstStepNs = nowNs + Constants::DIR_SETUP_US * NS_PER_US;
+        }
+    }
+    for (int wheel : {LEFT, RIGHT}) {
+        firstStepNs = std::max(firstStepNs, motors[wheel]->lastStepNs + motors[wheel]->planner.intervalNs(0));
+    }
+
+    const uint32_t leftAbs = static_cast<uint32_t>(std::abs(static_cast<int64_t>(wheelSteps[LEFT])));
+    const uint32_t rightAbs = static_cast<uint32_t>(std::abs(static_cast<int64_t>(wheelSteps[RIGHT])));
+    move.major = (leftAbs >= rightAbs) ? LEFT : RIGHT;
+    move.minor = (move.major == LEFT) ? RIGHT : LEFT;
+    move.majorSteps = std::max(leftAbs, rightAbs);
+    move.minorSteps = std::min(leftAbs, rightAbs);
+    move.stepsDone = 0;
+    move.error = move.majorSteps / 2;
+    move.rampStep = 0;
+    move.generation++;
+    move.lastStepNs = firstStepNs;
+    move.active = true;
+    pushEvent({firstStepNs, MOVE_EVENT, true, move.generation});
+}
+
+void MotorController::fireMoveStep(const StepEvent& event, uint64_t nowNs) {
+    const uint64_t pulseEndNs = nowNs + Constants::PULSE_WIDTH_US * NS_PER_US;
+
+    writeMotorPin(move.major, MotorPin::Pulse, Constants::PULSE_ACTIVE_LEVEL, nowNs);
+    pushEvent({pulseEndNs, move.major, false, 0});
+    recordStepRise(*motors[move.major], event.deadlineNs, nowNs);
+
+    // Bresenham: over majorSteps iterations the minor wheel steps exactly
+    // minorSteps times, evenly interleaved on the same edges.
+    move.error += move.minorSteps;
+    if (move.error >= move.majorSteps) {
+        move.error -= move.majorSteps;
+        writeMotorPin(move.minor, MotorPin::Pulse, Constants::PULSE_ACTIVE_LEVEL, nowNs);
+        pushEvent({pulseEndNs, move.minor, false, 0});
+        recordStepRise(*motors[move.minor], event.deadlineNs, nowNs);
+    }
 
-        uint32_t waitUs = stepInterval - elapsed;
-        if (waitUs > 1000) {
-            waitUs = 1000;
+    flashStepIndicator(nowNs);
+
+    const uint32_t remaining = move.majorSteps - ++move.stepsDone;
+    if (remaining == 0) {
+        // Joystick driving resumes from rest relative to the final step
+        motors[move.major]->lastStepNs = nowNs;
+        motors[move.minor]->lastStepNs = nowNs;
+        move.active = false;
+        // A move queued behind this one keeps the wheels busy
+        if (!movePending.load(std::memory_order_acquire)) {
+            moveActive.store(false, std::memory_order_release);
         }
-        delayUs(waitUs);
+        return;
+    }
+
+    // Finite-move ramp: decelerate once the remaining distance equals the
+    // steps needed to stop, otherwise climb towards max velocity.
+    const MotionPlanner& planner = motors[move.major]->planner;
+    if (remaining <= move.rampStep) {
+        move.rampStep = std::max<size_t>(move.rampStep - 1, 1);
+    } else if (move.rampStep < planner.rampLength()) {
+        move.rampStep++;
+    }
+
+    uint64_t intervalNs = std::max<uint64_t>(planner.intervalNs(move.rampStep - 1),
+                                             (Constants::PULSE_WIDTH_US + 1) * NS_PER_US);
+    move.lastStepNs = (nowNs - event.deadlineNs > intervalNs) ? nowNs : event.deadlineNs;
+    pushEvent({move.lastStepNs + intervalNs, MOVE_EVENT, true, move.generation});
+}
+
+void MotorController::flashStepIndicator(uint64_t nowNs) {
+    if (Constants::LED_GPIO >= 0) {
+        stepIndicatorDeadlineNs = nowNs + Constants::STEP_LED_DURATION_MS * 1000 * NS_PER_US;
+        if (!stepIndicatorOn) {
+            gpio->write(Constants::LED_GPIO, 1);
+            stepIndicatorOn = true;
+        }
+    }
+}
+
+void MotorController::updateStepIndicator(uint64_t nowNs) {
+    if (Constants::LED_GPIO >= 0 && stepIndicatorOn && nowNs >= stepIndicatorDeadlineNs) {
+        gpio->write(Constants::LED_GPIO, 0);
+        stepIndicatorOn = false;
+    }
+}
+
+// ─── Timing instrumentation ─────────────────────────────────────────────────
+
+void MotorController::recordStepRise(MotorState& motor, uint64_t deadlineNs, uint64_t nowNs) {
+    motor.stats.steps.fetch_add(1, std::memory_order_relaxed);
+    motor.pulseRiseNs = nowNs;
+
+    // In pulse-train mode the backend times the edges; nowNs is the ideal time
+    if (pulseMode != PulseMode::Direct) return;
+
+    const uint64_t latenessNs = (nowNs > deadlineNs) ? nowNs - deadlineNs : 0;
+    motor.stats.lateness.record(latenessNs);
+    if (latenessNs > Constants::STEP_DEADLINE_MISS_US * NS_PER_US) {
+        motor.stats.missedDeadlines.fetch_add(1, std::memory_order_relaxed);
+    }
+}
+
+void MotorController::recordStepFall(MotorState& motor, uint64_t nowNs) {
+    if (pulseMode != PulseMode::Direct) return;
+
+    const int64_t widthNs = static_cast<int64_t>(nowNs - motor.pulseRiseNs);
+    const int64_t errorNs = widthNs - static_cast<int64_t>(Constants::PULSE_WIDTH_US * NS_PER_US);
+    motor.stats.pulseWidthError.record(static_cast<uint64_t>(std::abs(errorNs)));
+}
+
+StepStatsSnapshot MotorController::stepStats(int motorIndex) const {
+    if (motorIndex >= 0 && motorIndex < static_cast<int>(motors.size())) {
+        return snapshotStepStats(motors[motorIndex]->stats);
     }
+    return {};
+}
 
-    lgGpioWrite(hGpio, motor->pins.pulse, !Constants::PULSE_ACTIVE_LEVEL);
-    lgGpioWrite(hGpio, motor->pins.enable, !Constants::ENABLE_ACTIVE_LEVEL);
+void MotorController::logStepStats(std::ostream& out) {
+    static constexpr const char* kAxisNames[] = {"L", "R", "PAN", "TILT"};
+    auto us = [](uint64_t ns) { return ns / NS_PER_US; };
+
+    const uint64_t iterations = schedulerIterations();
+    out << "STEP loops=" << (iterations - loggedIterations);
+    loggedIterations = iterations;
+
+    if (pulseMode == PulseMode::PulseTrain) {
+        const uint64_t underruns = pulseTrainUnderruns();
+        out << " underruns=" << (underruns - loggedUnderruns);
+        loggedUnderruns = underruns;
+    }
+
+    for (size_t i = 0; i < motors.size(); ++i) {
+        StepStatsSnapshot current = snapshotStepStats(motors[i]->stats);
+        StepStatsSnapshot interval = current - loggedStats[i];
+        loggedStats[i] = current;
+
+        out << " | " << kAxisNames[i] << " n=" << interval.steps;
+        if (interval.lateness.total() > 0) {
+            out << " late p50/p99/max=" << us(interval.lateness.percentile(0.50))
+                << "/" << us(interval.lateness.percentile(0.99))
+                << "/" << us(interval.lateness.max()) << "us"
+                << " pw.err p99=" << us(interval.pulseWidthError.percentile(0.99)) << "us"
+                << " miss=" << interval.missedDeadlines;
+        }
+    }
+    out << std::endl;
 }
@@ -1,8 +1,14 @@
 #pragma once
 #include <atomic>
+#include <memory>
+#include <ostream>
 #include <thread>
 #include <vector>
 #include "Constants.hpp"
+#include "GpioBackend.hpp"
+#include "MotionPlanner.hpp"
+#include "RealTime.hpp"
+#include "StepStats.hpp"
 
 struct MotorPins {
     unsigned enable;
@@ -12,40 +18,191 @@ struct MotorPins {
 
 struct MotorState {
     MotorPins pins;
+    MotionPlanner planner;
+    StepStats stats{};
     std::atomic<int16_t> targetSpeed{0};
     bool directionForward{true};
     bool enabled{false};
+
+    // Scheduler bookkeeping (only touched by the scheduler thread)
+    bool wantForward{true};         // commanded direction
+    size_t rampStep{0};             // position on the planner's ramp (0 = at rest)
+    size_t targetRampStep{0};       // ramp position matching the commanded speed
+    uint64_t cruiseIntervalNs{0};   // commanded step interval (0 = stop)
+    uint64_t lastStepNs{0};         // ideal deadline of the most recent step
+    uint64_t stepIntervalNs{0};     // interval the queued step was computed with
+    uint64_t pulseRiseNs{0};        // when the current pulse went active
+    uint32_t generation{0};         // bumped to invalidate queued step events
+    bool stepQueued{false};
+};
+
+// One entry in the scheduler's min-heap: a pulse edge due at deadlineNs.
+struct StepEvent {
+    uint64_t deadlineNs;
+    int motorIndex;
+    bool rising;                    // rising = start of step, falling = end of pulse
+    uint32_t generation;            // must match MotorState::generation for rising edges
+};
+
+// A differential-drive position move in progress (scheduler thread only).
+// The wheel with more steps to travel is the major axis: it follows the
+// planner ramp, and a Bresenham accumulator decides on each of its steps
+// whether the minor wheel steps too, so both share one timebase.
+struct CoordinatedMove {
+    bool active{false};
+    int major{0};
+    int minor{0};
+    uint32_t majorSteps{0};
+    uint32_t minorSteps{0};
+    uint32_t stepsDone{0};
+    uint32_t error{0};
+    size_t rampStep{0};
+    uint32_t generation{0};
+    uint64_t lastStepNs{0};
+};
+
+// How step edges reach the pins.
+//   Direct     – the scheduler thread sleeps until each edge and writes it.
+//   PulseTrain – the scheduler renders the next PULSE_TRAIN_WINDOW_MS of
+//                edges for every pin and hands them to the backend as one
+//                wave (lgTxWave on lgpio); timing is then generated there.
+enum class PulseMode {
+    Direct,
+    PulseTrain,
+};
+
+// Which of a motor's three outputs an edge applies to.
+enum class MotorPin {
+    Enable = 0,
+    Direction = 1,
+    Pulse = 2,
+};
+
+// One level change inside a pulse-train window (group-relative bits).
+struct PulseTrainEdge {
+    uint64_t timeUs;
+    uint64_t bits;
+    uint64_t mask;
 };
 
 class MotorController {
 public:
-    MotorController();
+    /// The controller owns the backend: LgpioBackend on the robot,
+    /// SimulatedGpioBackend for offline runs.
+    explicit MotorController(std::unique_ptr<GpioBackend> backend);
     ~MotorController();
 
+    /// Select how pulses are emitted.  Must be called before initialize().
+    void setPulseMode(PulseMode mode);
+    PulseMode getPulseMode() const { return pulseMode; }
+
+    /// Replace an axis' velocity/acceleration/jerk limits and rebuild its
+    /// ramp table.  Must be called before initialize().
+    void setAxisLimits(int motorIndex, const AxisLimits& limits);
+
+    /// Scheduling policy for the step scheduler thread.  Must be called
+    /// before initialize().
+    void setRealtimeConfig(const RealtimeConfig& config);
+
     bool initialize();
     void stop();
+    /// Takes effect immediately: a changed target wakes the scheduler.
+    /// Safe to call from any thread.
     void setSpeed(int motorIndex, int16_t speed);
 
+    /// Drive a straight line or arc: travel distanceMm along the path while
+    /// turning by headingRad (positive = counter-clockwise).  The drive
+    /// wheels ignore setSpeed() until the move completes or is cancelled.
+    void moveRelative(double distanceMm, double headingRad);
+
+    /// Ramp the active move down to a stop as quickly as the limits allow.
+    void cancelMove();
+
+    /// True from moveRelative() until the wheels have finished the move,
+    /// including any move queued behind the active one.
+    bool isMoving() const {
+        // Pending first: a move's start raises moveActive before it clears
+        // movePending, and its end only clears moveActive if none is queued
+        return movePending.load(std::memory_order_acquire) || moveActive.load(std::memory_order_acquire);
+    }
+
+    // ── Timing instrumentation (safe to call from any thread) ───────────
+    StepStatsSnapshot stepStats(int motorIndex) const;
+    uint64_t schedulerIterations() const { return loopIterations.load(std::memory_order_relaxed); }
+    uint64_t pulseTrainUnderruns() const { return waveUnderruns.load(std::memory_order_relaxed); }
+
+    /// Print one line of step timing for the interval since the previous
+    /// call.  Call from a single (logging) thread.
+    void logStepStats(std::ostream& out);
+
     // Motor Indices
     static constexpr int LEFT = 0;
     static constexpr int RIGHT = 1;
     static constexpr int PAN = 2;
     static constexpr int TILT = 3;
 
+    // StepEvent::motorIndex for the coordinated move's major-axis steps
+    static constexpr int MOVE_EVENT = -1;
+
 private:
-    int hGpio = -1;
+    std::unique_ptr<GpioBackend> gpio;
     std::vector<MotorState*> motors;
-    std::vector<std::thread> workers;
+    std::thread scheduler;
     std::atomic<bool> running{true};
-    
-    // LED handling
-    std::atomic<bool> stepIndicatorOn{false};
-    std::atomic<uint64_t> stepIndicatorDeadlineMs{0};
+    PulseMode pulseMode{PulseMode::Direct};
+    RealtimeConfig realtimeConfig;
+
+    // moveRelative() hand-off: packed left/right step counts
+    std::atomic<uint64_t> pendingMoveSteps{0};
+    std::atomic<bool> movePending{false};
+    std::atomic<bool> moveCancel{false};
+    std::atomic<bool> moveActive{false};
+    CoordinatedMove move;
+
+    // Set by setSpeed()/moveRelative()/cancelMove() before waking the
+    // scheduler, so new targets are picked up without waiting for the poll
+    std::atomic<bool> targetsChanged{false};
+
+    // Pending pulse edges for every motor, ordered by deadline (min-heap)
+    std::vector<StepEvent> eventQueue;
+
+    // Pulse-train mode: all motor pins are claimed as one backend group led
+    // by groupPins[0]; bit (motorIndex * 3 + MotorPin) addresses a single pin.
+    std::vector<int> groupPins;
+    std::vector<PulseTrainEdge> pulseTrain;
+
+    // Instrumentation: counters written by the scheduler, the logged
+    // baselines owned by whichever thread calls logStepStats()
+    std::atomic<uint64_t> loopIterations{0};
+    std::atomic<uint64_t> waveUnderruns{0};
+    std::vector<StepStatsSnapshot> loggedStats;
+    uint64_t loggedIterations{0};
+    uint64_t loggedUnderruns{0};
+
+    // LED handling (scheduler thread only)
+    bool stepIndicatorOn{false};
+    uint64_t stepIndicatorDeadlineNs{0};
 
-    void worker(MotorState* motor);
+    void schedulerLoop();
+    void runDirect();
+    void runPulseTrain();
+    void parkOutputs();
+    void pollTargets(uint64_t nowNs);
+    void requestPoll();
+    void updateMotor(int motorIndex, uint64_t nowNs);
+    void updateCoordinatedMove(uint64_t nowNs);
+    void fireEvent(const StepEvent& event, uint64_t nowNs);
+    void fireMoveStep(const StepEvent& event, uint64_t nowNs);
+    void flashStepIndicator(uint64_t nowNs);
+    void recordStepRise(MotorState& motor, uint64_t deadlineNs, uint64_t nowNs);
+    void recordStepFall(MotorState& motor, uint64_t nowNs);
+    bool ownedByMove(int motorIndex) const;
+    static uint64_t plannedIntervalNs(const MotorState& motor);
+    void writeMotorPin(int motorIndex, MotorPin pin, int level, uint64_t atNs);
+    bool claimPulseTrainGroup();
+    void pushEvent(const StepEvent& event);
+    void popEvent();
+    void advanceStep(int motorIndex, uint64_t deadlineNs);
+    void updateStepIndicator(uint64_t nowNs);
     void ensurePinSetup(const MotorPins& pins);
-    
-    // Helpers
-    static uint32_t tickDiff(uint32_t later, uint32_t earlier);
-    static uint64_t steadyClockMs();
 };
@@ -0,0 +1,70 @@
+#include "RealTime.hpp"
+#include <alloca.h>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace {
+    // Touch the stack once now so later growth never faults.  noinline keeps
+    // the alloca in its own frame below the caller's.
+    __attribute__((noinline)) void prefaultStack(size_t bytes) {
+        const size_t pageSize = static_cast<size_t>(sysconf(_SC_PAGESIZE));
+        volatile unsigned char* stack = static_cast<volatile unsigned char*>(alloca(bytes));
+        for (size_t i = 0; i < bytes; i += pageSize) {
+            stack[i] = 0;
+        }
+    }
+}
+
+bool RealTime::lockMemory() {
+    if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+        std::cerr << "RT: mlockall failed (" << std::strerror(errno)
+                  << "), continuing with pageable memory\n";
+        return false;
+    }
+    std::cout << "RT: process memory locked\n";
+    return true;
+}
+
+bool RealTime::configureCurrentThread(const RealtimeConfig& config, const char* name) {
+    pthread_setname_np(pthread_self(), name);
+    if (!config.enabled) return true;
+
+    bool ok = true;
+
+    if (config.cpu >= 0) {
+        cpu_set_t cpus;
+        CPU_ZERO(&cpus);
+        CPU_SET(config.cpu, &cpus);
+        int rc = pthread_setaffinity_np(pthread_self(), sizeof(cpus), &cpus);
+        if (rc != 0) {
+            std::cerr << "RT: " << name << " could not pin to CPU " << config.cpu
+                      << " (" << std::strerror(rc) << ")\n";
+            ok = false;
+        }
+    }
+
+    sched_param param{};
+    param.sched_priority = config.priority;
+    int rc = pthread_setschedparam(pthread_self(), SCHED_FIFO, &param);
+    if (rc != 0) {
+        std::cerr << "RT: " << name << " could not switch to SCHED_FIFO "
+                  << config.priority << " (" << std::strerror(rc) << ")\n";
+        ok = false;
+    }
+
+    if (config.stackPrefaultBytes > 0) {
+        prefaultStack(config.stackPrefaultBytes);
+    }
+
+    if (ok) {
+        std::cout << "RT: " << name << " SCHED_FIFO " << config.priority;
+        if (config.cpu >= 0) std::cout << " on CPU " << config.cpu;
+        std::cout << '\n';
+    }
+    return ok;
+}
@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include "Constants.hpp"
+
+// ─── Real-time thread configuration ─────────────────────────────────────────
+//
+//  Scheduling policy, CPU affinity and memory locking for the timing
+//  critical threads (step scheduler, input workers).  Every call degrades
+//  gracefully: without CAP_SYS_NICE / CAP_IPC_LOCK (or on a kernel without
+//  the requested CPU) a warning is logged and the thread carries on with
+//  the default SCHED_OTHER policy.
+//
+struct RealtimeConfig {
+    bool enabled = false;
+    int priority = 0;                   // SCHED_FIFO priority (1–99)
+    int cpu = -1;                       // core to pin to, -1 = any
+    size_t stackPrefaultBytes = Constants::RT_STACK_PREFAULT_BYTES;
+};
+
+namespace RealTime {
+    /// mlockall(MCL_CURRENT | MCL_FUTURE) so no page fault lands in a
+    /// step loop.  Call once from main() before any thread starts.
+    bool lockMemory();
+
+    /// Apply policy, priority, affinity and stack prefaulting to the
+    /// calling thread.  `name` labels the thread (≤15 chars) and the logs.
+    bool configureCurrentThread(const RealtimeConfig& config, const char* name);
+}
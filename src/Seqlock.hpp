@@ -0,0 +1,61 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+// ─── Seqlock ────────────────────────────────────────────────────────────────
+//
+//  One writer publishes a small trivially-copyable value; any number of
+//  readers take consistent copies without locking or writing shared memory.
+//  The sequence is odd while a store is in progress; a reader that sees it
+//  odd, or changed across its copy, simply copies again.
+//
+//  The payload is held as relaxed atomic words, so a torn read is a retry
+//  rather than a data race.  Writers must be serialised by the caller.
+//  Until the first store(), load() returns all-zero bytes.
+//
+template <typename T>
+class Seqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "Seqlock payload must be trivially copyable");
+    static constexpr size_t WORDS = (sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t);
+
+public:
+    Seqlock() {
+        for (auto& word : data) word.store(0, std::memory_order_relaxed);
+    }
+
+    void store(const T& value) {
+        uint64_t words[WORDS] = {};
+        std::memcpy(words, &value, sizeof(T));
+
+        const uint32_t seq = sequence.load(std::memory_order_relaxed);
+        sequence.store(seq + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i = 0; i < WORDS; ++i) data[i].store(words[i], std::memory_order_relaxed);
+        sequence.store(seq + 2, std::memory_order_release);
+    }
+
+    T load() const {
+        uint64_t words[WORDS];
+        uint32_t before, after;
+        do {
+            before = sequence.load(std::memory_order_acquire);
+            for (size_t i = 0; i < WORDS; ++i) words[i] = data[i].load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            after = sequence.load(std::memory_order_relaxed);
+        } while ((before & 1) != 0 || before != after);
+
+        T value;
+        std::memcpy(&value, words, sizeof(T));
+        return value;
+    }
+
+    /// Number of stores so far.
+    uint32_t version() const { return sequence.load(std::memory_order_acquire) >> 1; }
+
+private:
+    std::atomic<uint32_t> sequence{0};
+    std::atomic<uint64_t> data[WORDS];
+};
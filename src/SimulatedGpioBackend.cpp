@@ -0,0 +1,140 @@
+#include "SimulatedGpioBackend.hpp"
+#include <algorithm>
+#include <chrono>
+
+SimulatedGpioBackend::SimulatedGpioBackend(uint64_t startNs)
+    : clockNs(startNs)
+{
+}
+
+bool SimulatedGpioBackend::claimOutput(unsigned gpio, int level) {
+    write(gpio, level);
+    return true;
+}
+
+void SimulatedGpioBackend::write(unsigned gpio, int level) {
+    std::lock_guard<std::mutex> lk(mutex);
+    recordEdge(nowNs(), gpio, level);
+}
+
+bool SimulatedGpioBackend::claimGroup(const std::vector<int>& gpios, const std::vector<int>& levels) {
+    std::lock_guard<std::mutex> lk(mutex);
+    groupPins = gpios;
+    for (size_t i = 0; i < gpios.size(); ++i) {
+        recordEdge(nowNs(), static_cast<unsigned>(gpios[i]), levels[i]);
+    }
+    return true;
+}
+
+void SimulatedGpioBackend::groupWrite(uint64_t bits, uint64_t mask) {
+    std::lock_guard<std::mutex> lk(mutex);
+    for (size_t i = 0; i < groupPins.size(); ++i) {
+        if (mask & (1ULL << i)) {
+            recordEdge(nowNs(), static_cast<unsigned>(groupPins[i]), (bits >> i) & 1);
+        }
+    }
+}
+
+bool SimulatedGpioBackend::submitWave(const GpioPulse* pulses, size_t count) {
+    std::lock_guard<std::mutex> lk(mutex);
+
+    // Waves queue back to back, starting now if the queue has drained
+    uint64_t cursorNs = std::max(waveEndNs, nowNs());
+    for (size_t p = 0; p < count; ++p) {
+        for (size_t i = 0; i < groupPins.size(); ++i) {
+            if (pulses[p].mask & (1ULL << i)) {
+                recordEdge(cursorNs, static_cast<unsigned>(groupPins[i]), (pulses[p].bits >> i) & 1);
+            }
+        }
+        cursorNs += pulses[p].delayUs * 1000;
+    }
+    waveEndNs = cursorNs;
+    return true;
+}
+
+bool SimulatedGpioBackend::waveBusy() {
+    std::lock_guard<std::mutex> lk(mutex);
+    return nowNs() < waveEndNs;
+}
+
+void SimulatedGpioBackend::sleepUntilNs(uint64_t deadlineNs) {
+    std::unique_lock<std::mutex> lk(mutex);
+    const uint64_t wakeNs = deadlineNs + wakeLatencyNs;
+
+    // Woken before or while sleeping: return with the clock where it is
+    if (wakePending) {
+        wakePending = false;
+        return;
+    }
+
+    if (wakeNs > horizonNs) {
+        // Park at the horizon; give up after a real millisecond so the
+        // caller can notice shutdown, exactly like a spurious wake-up.
+        clockNs.store(std::max(nowNs(), horizonNs), std::memory_order_release);
+        parkedAtHorizon = true;
+        parked.notify_all();
+        horizonChanged.wait_for(lk, std::chrono::milliseconds(1));
+        parkedAtHorizon = false;
+        wakePending = false;
+        return;
+    }
+
+    clockNs.store(std::max(nowNs(), wakeNs), std::memory_order_release);
+}
+
+void SimulatedGpioBackend::wake() {
+    std::lock_guard<std::mutex> lk(mutex);
+    wakePending = true;
+    horizonChanged.notify_all();
+}
+
+void SimulatedGpioBackend::setWakeLatencyNs(uint64_t latencyNs) {
+    std::lock_guard<std::mutex> lk(mutex);
+    wakeLatencyNs = latencyNs;
+}
+
+void SimulatedGpioBackend::setHorizonNs(uint64_t horizon) {
+    std::lock_guard<std::mutex> lk(mutex);
+    horizonNs = horizon;
+    horizonChanged.notify_all();
+}
+
+void SimulatedGpioBackend::advanceNs(uint64_t deltaNs) {
+    std::lock_guard<std::mutex> lk(mutex);
+    if (horizonNs == FREE_RUNNING) return;
+    horizonNs = std::max(horizonNs, nowNs()) + deltaNs;
+    horizonChanged.notify_all();
+}
+
+void SimulatedGpioBackend::waitForHorizon() {
+    std::unique_lock<std::mutex> lk(mutex);
+    parked.wait(lk, [this] { return parkedAtHorizon && nowNs() >= horizonNs; });
+}
+
+std::vector<GpioEdge> SimulatedGpioBackend::edges() const {
+    std::lock_guard<std::mutex> lk(mutex);
+    return edgeLog;
+}
+
+std::vector<GpioEdge> SimulatedGpioBackend::edgesFor(unsigned gpio) const {
+    std::lock_guard<std::mutex> lk(mutex);
+    std::vector<GpioEdge> result;
+    for (const auto& edge : edgeLog) {
+        if (edge.gpio == gpio) result.push_back(edge);
+    }
+    return result;
+}
+
+void SimulatedGpioBackend::setRecording(bool enabled) {
+    std::lock_guard<std::mutex> lk(mutex);
+    recording = enabled;
+}
+
+void SimulatedGpioBackend::clearEdges() {
+    std::lock_guard<std::mutex> lk(mutex);
+    edgeLog.clear();
+}
+
+void SimulatedGpioBackend::recordEdge(uint64_t timeNs, unsigned gpio, int level) {
+    if (recording) edgeLog.push_back({timeNs, gpio, level});
+}
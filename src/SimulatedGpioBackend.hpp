@@ -0,0 +1,89 @@
+#pragma once
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <limits>
+#include <mutex>
+#include <vector>
+#include "GpioBackend.hpp"
+
+// A level change seen on a simulated pin, stamped with virtual time.
+struct GpioEdge {
+    uint64_t timeNs;
+    unsigned gpio;
+    int level;
+};
+
+// ─── Simulated GPIO backend ─────────────────────────────────────────────────
+//
+//  Runs the step scheduler against a virtual clock: sleepUntilNs() jumps
+//  time forward instead of blocking, so seconds of motion simulate in
+//  milliseconds.  Every pin write (and every edge of a submitted wave,
+//  expanded on its own timeline) is appended to an edge log.
+//
+//  By default time runs freely.  Set a horizon to step it deterministically:
+//  the scheduler blocks once it reaches the horizon until advanceNs() moves
+//  it on, and waitForHorizon() lets the driving thread sync up.  wake()
+//  ends a sleep without advancing time, so a setSpeed() made while the
+//  scheduler is parked takes effect at the parked instant.
+//
+//      SimulatedGpioBackend* sim = ...;
+//      sim->setHorizonNs(0);
+//      controller.setSpeed(MotorController::PAN, 500);
+//      sim->advanceNs(1'000'000'000);      // one virtual second
+//      sim->waitForHorizon();
+//      auto edges = sim->edgesFor(Constants::MOTOR_PAN_PULSE);
+//
+class SimulatedGpioBackend : public GpioBackend {
+public:
+    static constexpr uint64_t FREE_RUNNING = std::numeric_limits<uint64_t>::max();
+
+    explicit SimulatedGpioBackend(uint64_t startNs = 0);
+
+    bool open() override { return true; }
+    void close() override {}
+
+    bool claimOutput(unsigned gpio, int level) override;
+    void write(unsigned gpio, int level) override;
+
+    bool claimGroup(const std::vector<int>& gpios, const std::vector<int>& levels) override;
+    void groupWrite(uint64_t bits, uint64_t mask) override;
+
+    bool submitWave(const GpioPulse* pulses, size_t count) override;
+    int waveRoom() override { return 1000; }
+    bool waveBusy() override;
+
+    uint64_t nowNs() override { return clockNs.load(std::memory_order_acquire); }
+    void sleepUntilNs(uint64_t deadlineNs) override;
+    void wake() override;
+
+    // ── Virtual time control ────────────────────────────────────────────
+    void setWakeLatencyNs(uint64_t latencyNs);      // added to every sleep
+    void setHorizonNs(uint64_t horizonNs);
+    void advanceNs(uint64_t deltaNs);
+    void waitForHorizon();                          // until a sleeper is parked at the horizon
+
+    // ── Recorded output ─────────────────────────────────────────────────
+    void setRecording(bool enabled);                // off for long benchmark runs
+    std::vector<GpioEdge> edges() const;            // in emission order
+    std::vector<GpioEdge> edgesFor(unsigned gpio) const;
+    void clearEdges();
+
+private:
+    std::atomic<uint64_t> clockNs;
+    uint64_t wakeLatencyNs = 0;
+    uint64_t horizonNs = FREE_RUNNING;
+    bool parkedAtHorizon = false;
+    bool wakePending = false;                       // next sleep returns at once
+    bool recording = true;
+
+    std::vector<int> groupPins;
+    uint64_t waveEndNs = 0;                         // where the next wave starts playing
+
+    mutable std::mutex mutex;
+    std::condition_variable horizonChanged;
+    std::condition_variable parked;
+    std::vector<GpioEdge> edgeLog;
+
+    void recordEdge(uint64_t timeNs, unsigned gpio, int level);
+};
@@ -0,0 +1,85 @@
+#include "StepStats.hpp"
+#include <bit>
+
+size_t LatencyHistogram::bucketIndex(uint64_t value) {
+    if (value < SUB_BUCKETS) return static_cast<size_t>(value);
+
+    const unsigned msb = 63 - static_cast<unsigned>(std::countl_zero(value));
+    const unsigned shift = msb - SUB_BUCKET_BITS;
+    const size_t sub = static_cast<size_t>(value >> shift) & (SUB_BUCKETS - 1);
+    return (shift + 1) * SUB_BUCKETS + sub;
+}
+
+uint64_t LatencyHistogram::bucketLowerBound(size_t index) {
+    if (index < SUB_BUCKETS) return index;
+
+    const unsigned shift = static_cast<unsigned>(index / SUB_BUCKETS) - 1;
+    const uint64_t sub = index % SUB_BUCKETS;
+    return (SUB_BUCKETS + sub) << shift;
+}
+
+HistogramSnapshot LatencyHistogram::snapshot() const {
+    HistogramSnapshot snap;
+    for (size_t i = 0; i < BUCKET_COUNT; ++i) {
+        snap.counts[i] = counts[i].load(std::memory_order_relaxed);
+    }
+    return snap;
+}
+
+uint64_t HistogramSnapshot::total() const {
+    uint64_t sum = 0;
+    for (uint32_t c : counts) sum += c;
+    return sum;
+}
+
+uint64_t HistogramSnapshot::percentile(double fraction) const {
+    const uint64_t sum = total();
+    if (sum == 0) return 0;
+
+    const uint64_t rank = static_cast<uint64_t>(fraction * static_cast<double>(sum));
+    uint64_t seen = 0;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        seen += counts[i];
+        if (seen > rank) {
+            return (i + 1 < counts.size()) ? LatencyHistogram::bucketLowerBound(i + 1) - 1
+                                           : LatencyHistogram::bucketLowerBound(i);
+        }
+    }
+    return max();
+}
+
+uint64_t HistogramSnapshot::max() const {
+    for (size_t i = counts.size(); i-- > 0;) {
+        if (counts[i] != 0) {
+            return (i + 1 < counts.size()) ? LatencyHistogram::bucketLowerBound(i + 1) - 1
+                                           : LatencyHistogram::bucketLowerBound(i);
+        }
+    }
+    return 0;
+}
+
+HistogramSnapshot HistogramSnapshot::operator-(const HistogramSnapshot& earlier) const {
+    HistogramSnapshot diff;
+    for (size_t i = 0; i < counts.size(); ++i) {
+        diff.counts[i] = counts[i] - earlier.counts[i];
+    }
+    return diff;
+}
+
+StepStatsSnapshot StepStatsSnapshot::operator-(const StepStatsSnapshot& earlier) const {
+    StepStatsSnapshot diff;
+    diff.lateness = lateness - earlier.lateness;
+    diff.pulseWidthError = pulseWidthError - earlier.pulseWidthError;
+    diff.steps = steps - earlier.steps;
+    diff.missedDeadlines = missedDeadlines - earlier.missedDeadlines;
+    return diff;
+}
+
+StepStatsSnapshot snapshotStepStats(const StepStats& stats) {
+    StepStatsSnapshot snap;
+    snap.lateness = stats.lateness.snapshot();
+    snap.pulseWidthError = stats.pulseWidthError.snapshot();
+    snap.steps = stats.steps.load(std::memory_order_relaxed);
+    snap.missedDeadlines = stats.missedDeadlines.load(std::memory_order_relaxed);
+    return snap;
+}
@@ -0,0 +1,70 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+// ─── Log-linear latency histogram ───────────────────────────────────────────
+//
+//  HDR-style bucketing: values below 2^SUB_BUCKET_BITS get one bucket each,
+//  every power of two above that is split into SUB_BUCKETS linear buckets,
+//  so relative error stays under 12.5 % from nanoseconds to minutes.
+//
+//  record() is wait-free (one relaxed fetch_add) and intended for a single
+//  writer — the step scheduler thread.  Any thread may take snapshots.
+//
+struct HistogramSnapshot;
+
+class LatencyHistogram {
+public:
+    static constexpr unsigned SUB_BUCKET_BITS = 3;
+    static constexpr size_t SUB_BUCKETS = size_t{1} << SUB_BUCKET_BITS;
+    static constexpr size_t BUCKET_COUNT = (64 - SUB_BUCKET_BITS + 1) * SUB_BUCKETS;
+
+    void record(uint64_t value) {
+        counts[bucketIndex(value)].fetch_add(1, std::memory_order_relaxed);
+    }
+
+    HistogramSnapshot snapshot() const;
+
+    static size_t bucketIndex(uint64_t value);
+    static uint64_t bucketLowerBound(size_t index);
+
+private:
+    std::array<std::atomic<uint32_t>, BUCKET_COUNT> counts{};
+};
+
+// Plain copy of a histogram; subtract two to get the counts for an interval.
+struct HistogramSnapshot {
+    std::array<uint32_t, LatencyHistogram::BUCKET_COUNT> counts{};
+
+    uint64_t total() const;
+    uint64_t percentile(double fraction) const;     // upper bound of the bucket
+    uint64_t max() const;
+    HistogramSnapshot operator-(const HistogramSnapshot& earlier) const;
+};
+
+// ─── Per-axis step timing ───────────────────────────────────────────────────
+//
+//  Lateness is the time from a rising edge's ideal deadline to the moment
+//  the scheduler issued it; pulse-width error is |measured − PULSE_WIDTH_US|.
+//  Both are in nanoseconds and only sampled in PulseMode::Direct, where
+//  user space owns the edge timing.
+//
+struct StepStats {
+    LatencyHistogram lateness;
+    LatencyHistogram pulseWidthError;
+    std::atomic<uint64_t> steps{0};
+    std::atomic<uint64_t> missedDeadlines{0};   // lateness > STEP_DEADLINE_MISS_US
+};
+
+struct StepStatsSnapshot {
+    HistogramSnapshot lateness;
+    HistogramSnapshot pulseWidthError;
+    uint64_t steps = 0;
+    uint64_t missedDeadlines = 0;
+
+    StepStatsSnapshot operator-(const StepStatsSnapshot& earlier) const;
+};
+
+StepStatsSnapshot snapshotStepStats(const StepStats& stats);
@@ -1,14 +1,20 @@
 #include <iostream>
 #include <csignal>
-#include <cmath>
-#include <algorithm>
 #include <thread>
 #include <chrono>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
 
 #include "Constants.hpp"
 #include "MotorController.hpp"
 #include "InputManager.hpp"
 #include "LedController.hpp"
+#include "LgpioBackend.hpp"
+#include "Mixing.hpp"
+#include "RealTime.hpp"
 
 std::atomic<bool> running{true};
 
@@ -16,104 +22,179 @@ void signalHandler(int) {
     running.store(false);
 }
 
-int clamp(int value, int minValue, int maxValue) {
-    return std::max(minValue, std::min(value, maxValue));
-}
-
-int scaleAxis(int16_t raw) {
-    double normalized = static_cast<double>(raw) / Constants::MAX_JOYSTICK_VALUE;
-    int scaled = static_cast<int>(std::lround(normalized * 512.0));
-    return clamp(scaled, -512, 512);
-}
-
-int16_t commandToSpeed(int command) {
-    if (std::abs(command) < Constants::JOYSTICK_DEADZONE) {
-        return 0;
+int main(int argc, char* argv[]) {
+    const char* joystickPath = nullptr;
+    PulseMode pulseMode = PulseMode::Direct;
+    RealtimeConfig motorRt{true, Constants::RT_MOTOR_PRIORITY, Constants::RT_MOTOR_CPU};
+    RealtimeConfig inputRt{true, Constants::RT_INPUT_PRIORITY, Constants::RT_INPUT_CPU};
+    const char* segmentMapPath = Constants::LED_SEGMENT_MAP_PATH;
+
+    // --led-strip=DEVICE[:PIXELS[:SEGMENT_MAP]], repeatable; one default strip otherwise
+    struct StripSpec {
+        LedStripConfig config;
+        std::string segmentMap;
+    };
+    std::vector<StripSpec> stripSpecs;
+    LedEncoding ledEncoding = LedEncoding::Spi8Bit;
+    int udpReceiveBuffer = Constants::UDP_RECEIVE_BUFFER_BYTES;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--pulse-train") == 0) {
+            pulseMode = PulseMode::PulseTrain;
+        } else if (std::strcmp(argv[i], "--no-rt") == 0) {
+            motorRt.enabled = false;
+            inputRt.enabled = false;
+        } else if (std::strncmp(argv[i], "--rt-priority=", 14) == 0) {
+            motorRt.priority = std::atoi(argv[i] + 14);
+        } else if (std::strncmp(argv[i], "--rt-cpu=", 9) == 0) {
+            motorRt.cpu = std::atoi(argv[i] + 9);
+        } else if (std::strncmp(argv[i], "--input-rt-priority=", 20) == 0) {
+            inputRt.priority = std::atoi(argv[i] + 20);
+        } else if (std::strncmp(argv[i], "--led-segments=", 15) == 0) {
+            segmentMapPath = argv[i] + 15;
+        } else if (std::strncmp(argv[i], "--udp-rcvbuf=", 13) == 0) {
+            udpReceiveBuffer = std::atoi(argv[i] + 13);
+        } else if (std::strcmp(argv[i], "--led-3bit") == 0) {
+            ledEncoding = LedEncoding::Spi3Bit;
+        } else if (std::strncmp(argv[i], "--led-strip=", 12) == 0) {
+            std::string spec = argv[i] + 12;
+            StripSpec strip;
+            size_t colon = spec.find(':');
+            strip.config.device = spec.substr(0, colon);
+            if (colon != std::string::npos) {
+                spec = spec.substr(colon + 1);
+                colon = spec.find(':');
+                int pixels = std::atoi(spec.substr(0, colon).c_str());
+                if (pixels > 0) strip.config.pixelCount = static_cast<uint16_t>(pixels);
+                if (colon != std::string::npos) strip.segmentMap = spec.substr(colon + 1);
+            }
+            stripSpecs.push_back(strip);
+        } else {
+            joystickPath = argv[i];
+        }
     }
-    long scaled = static_cast<long>(command) * Constants::MAX_SPEED_STEPS_PER_SEC;
-    scaled /= 512;
-    return static_cast<int16_t>(scaled);
-}
 
-int main(int argc, char* argv[]) {
-    const char* joystickPath = (argc > 1) ? argv[1] : nullptr;
+    if (motorRt.enabled) {
+        RealTime::lockMemory();
+    }
 
     std::signal(SIGINT, signalHandler);
     std::signal(SIGTERM, signalHandler);
 
-    MotorController motorController;
+    MotorController motorController(std::make_unique<LgpioBackend>());
+    motorController.setPulseMode(pulseMode);
+    motorController.setRealtimeConfig(motorRt);
     if (!motorController.initialize()) {
         return 1;
     }
 
-    LedController ledController;
-    if (!ledController.initialize()) {
-        std::cerr << "LED controller init failed (continuing without LEDs)" << std::endl;
+    if (stripSpecs.empty()) {
+        stripSpecs.push_back({});
+    }
+    if (stripSpecs.front().segmentMap.empty()) {
+        stripSpecs.front().segmentMap = segmentMapPath;
     }
 
+    // One controller (and render thread) per strip; LedController is not
+    // movable, hence the unique_ptrs
+    std::vector<std::unique_ptr<LedController>> ledStrips;
+    for (auto& spec : stripSpecs) {
+        spec.config.encoding = ledEncoding;
+        auto strip = std::make_unique<LedController>(spec.config);
+        if (!spec.segmentMap.empty()) {
+            strip->loadSegments(spec.segmentMap.c_str());
+        }
+        if (!strip->initialize()) {
+            std::cerr << "LED controller init failed on " << spec.config.device
+                      << " (continuing without it)" << std::endl;
+        }
+
+        // Default face: eyes that follow the turret stick (setLook below).
+        // Without eye segments in the map the whole strip is one eye.
+        LedEffect eye;
+        eye.type = LedEffectType::EyeLook;
+        eye.colour = {0, 160, 255};
+        eye.width = 3;
+        const bool leftEye = strip->addEffect("left_eye", eye) >= 0;
+        const bool rightEye = strip->addEffect("right_eye", eye) >= 0;
+        if (!leftEye && !rightEye) {
+            strip->effects().add(eye);
+        }
+
+        ledStrips.push_back(std::move(strip));
+    }
+
+    // Input → mixing → motor targets, pushed from the input thread as soon
+    // as a joystick event or UDP batch lands; setSpeed() wakes the step
+    // scheduler, so nothing on this path waits for a poll
     InputManager inputManager;
+    inputManager.setRealtimeConfig(inputRt);
+    inputManager.setReceiveBufferSize(udpReceiveBuffer);
+    inputManager.setOnChange([&]() {
+        // One snapshot per update: every axis comes from the same packet
+        const InputSnapshot input = inputManager.snapshot();
+        MotorSpeeds speeds = mixAxes(input.axes[Constants::JOYSTICK_AXIS_X],
+                                     input.axes[Constants::JOYSTICK_AXIS_Y],
+                                     input.axes[Constants::JOYSTICK_AXIS_RX],
+                                     input.axes[Constants::JOYSTICK_AXIS_RY]);
+
+        motorController.setSpeed(MotorController::LEFT, speeds.left);
+        motorController.setSpeed(MotorController::RIGHT, speeds.right);
+        motorController.setSpeed(MotorController::PAN, speeds.pan);
+        motorController.setSpeed(MotorController::TILT, speeds.tilt);
+
+        // Eyes follow the turret stick
+        for (auto& strip : ledStrips) {
+            strip->effects().setLook(input.axes[Constants::JOYSTICK_AXIS_RX],
+                                     input.axes[Constants::JOYSTICK_AXIS_RY]);
+        }
+    });
     inputManager.start(joystickPath);
 
     std::cout << "System initialized. Waiting for input..." << std::endl;
 
-    auto nextLedUpdate = std::chrono::steady_clock::now();
+    // ── LED frame ─────────────────────────────────────────────────────
+    //
+    //  Dark base frame at the default brightness; the eye effects draw
+    //  the face on top of it.
+    //
+    //  Published once: the render threads keep refreshing the strips on
+    //  their own clock, so nothing here needs to tick.
+    //
+    for (auto& strip : ledStrips) {
+        strip->setBrightness(Constants::LED_DEFAULT_BRIGHTNESS);
+        strip->clear();
+        strip->show();
+    }
 
     auto nextLogTime = std::chrono::steady_clock::now();
 
+    // Input is pushed straight to the motors, so the main thread only logs
     while (running.load(std::memory_order_relaxed)) {
-        // Read Inputs
-        int xScaled = -scaleAxis(inputManager.getAxis(Constants::JOYSTICK_AXIS_X));
-        int yScaled = -scaleAxis(inputManager.getAxis(Constants::JOYSTICK_AXIS_Y));
-        int rxScaled = scaleAxis(inputManager.getAxis(Constants::JOYSTICK_AXIS_RX));
-        int ryScaled = -scaleAxis(inputManager.getAxis(Constants::JOYSTICK_AXIS_RY));
-
-        // Deadzone
-        int xCommandRaw = (std::abs(xScaled) < Constants::JOYSTICK_DEADZONE) ? 0 : xScaled;
-        int yCommandRaw = (std::abs(yScaled) < Constants::JOYSTICK_DEADZONE) ? 0 : yScaled;
-        int panCommand = (std::abs(rxScaled) < Constants::JOYSTICK_DEADZONE) ? 0 : rxScaled;
-        int tiltCommand = (std::abs(ryScaled) < Constants::JOYSTICK_DEADZONE) ? 0 : ryScaled;
-
-        // Mixing (X = forward/backward, Y = turning)
-        int leftMixCommand = clamp(xCommandRaw + yCommandRaw, -512, 512);
-        int rightMixCommand = clamp(xCommandRaw - yCommandRaw, -512, 512);
-
-        // Update Motors
-        motorController.setSpeed(MotorController::LEFT, commandToSpeed(leftMixCommand));
-        motorController.setSpeed(MotorController::RIGHT, commandToSpeed(rightMixCommand));
-        motorController.setSpeed(MotorController::PAN, commandToSpeed(panCommand));
-        motorController.setSpeed(MotorController::TILT, commandToSpeed(tiltCommand));
-
-        // ── LED update tick ───────────────────────────────────────────
-        //
-        //  TEST MODE: all 144 pixels full white at max brightness.
-        //  Revert to segment-based logic once the test is confirmed.
-        //
         auto now = std::chrono::steady_clock::now();
-        if (now >= nextLedUpdate) {
-            ledController.setBrightness(255);
-            ledController.fill(255, 255, 255);
-            ledController.show();
-            nextLedUpdate = now + std::chrono::milliseconds(Constants::LED_REFRESH_INTERVAL_MS);
-        }
 
         // Logging
         if (now >= nextLogTime) {
-            std::cout << "JOY X=" << xCommandRaw
-                      << " Y=" << yCommandRaw
-                      << " RX=" << panCommand
-                      << " RY=" << tiltCommand
-                      << " MixL=" << leftMixCommand
-                      << " MixR=" << rightMixCommand
-                      << std::endl;
+            motorController.logStepStats(std::cout);
+
+            const LinkStats link = inputManager.linkStats();
+            if (link.received > 0) {
+                std::cout << "NET rx=" << link.received << " lost=" << link.lost
+                          << " (" << link.lossRate * 100.0f << "%) reordered=" << link.reordered
+                          << " stale=" << link.stale << " coalesced=" << inputManager.coalescedPackets()
+                          << " delay=" << link.delayMs
+                          << "ms jitter=" << link.jitterMs << "ms\n";
+            }
             nextLogTime = now + std::chrono::milliseconds(Constants::LOG_INTERVAL_MS);
         }
 
-        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+        std::this_thread::sleep_until(nextLogTime);
     }
 
     std::cout << "Shutting down..." << std::endl;
     inputManager.stop();
-    ledController.stop();
+    for (auto& strip : ledStrips) {
+        strip->stop();
+    }
     motorController.stop();
 
     return 0;
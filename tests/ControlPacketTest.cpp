@@ -0,0 +1,107 @@
+#include "Test.hpp"
+#include "ControlPacket.hpp"
+#include <cstring>
+
+namespace {
+
+ControlPacket samplePacket() {
+    ControlPacket packet;
+    packet.sequence = 0xA1B2C3D4u;
+    packet.leftX = 8192;
+    packet.leftY = -16384;
+    packet.rightX = -32768;
+    packet.rightY = 32767;
+    packet.buttons = 0x80000005u;
+    packet.hasTimestamp = true;
+    packet.sentUs = 0xFFFFFFF0u;
+    return packet;
+}
+
+void TEST_ControlPacketRoundTrip() {
+    const ControlPacket sent = samplePacket();
+    uint8_t datagram[CONTROL_PACKET_SIZE];
+    encodeControlPacket(sent, datagram);
+
+    ControlPacket got;
+    CHECK(decodeControlPacket(datagram, sizeof(datagram), got) == ControlPacketStatus::Ok);
+    CHECK_EQ(got.sequence, sent.sequence);
+    CHECK_EQ(got.leftX, sent.leftX);
+    CHECK_EQ(got.leftY, sent.leftY);
+    CHECK_EQ(got.rightX, sent.rightX);
+    CHECK_EQ(got.rightY, sent.rightY);
+    CHECK_EQ(got.buttons, sent.buttons);
+    CHECK(got.hasTimestamp);
+    CHECK_EQ(got.sentUs, sent.sentUs);
+}
+TEST(TEST_ControlPacketRoundTrip);
+
+// Version 1: the same fields without the timestamp, CRC right after buttons
+void TEST_ControlPacketVersion1() {
+    uint8_t v2[CONTROL_PACKET_SIZE];
+    encodeControlPacket(samplePacket(), v2);
+
+    uint8_t v1[CONTROL_PACKET_V1_SIZE];
+    std::memcpy(v1, v2, 20);
+    v1[2] = 1;
+    const uint32_t crc = crc32(v1, 20);
+    for (int i = 0; i < 4; ++i) v1[20 + i] = static_cast<uint8_t>(crc >> (8 * i));
+
+    ControlPacket got;
+    CHECK(decodeControlPacket(v1, sizeof(v1), got) == ControlPacketStatus::Ok);
+    CHECK_EQ(got.leftY, samplePacket().leftY);
+    CHECK(!got.hasTimestamp);
+    CHECK_EQ(got.sentUs, 0u);
+}
+TEST(TEST_ControlPacketVersion1);
+
+// Any single flipped bit, in a field or in the CRC itself, is caught, and
+// a rejected packet leaves the output untouched
+void TEST_ControlPacketBadCrc() {
+    uint8_t good[CONTROL_PACKET_SIZE];
+    encodeControlPacket(samplePacket(), good);
+
+    for (size_t byte = 3; byte < CONTROL_PACKET_SIZE; ++byte) {
+        for (unsigned bit = 0; bit < 8; ++bit) {
+            uint8_t bad[CONTROL_PACKET_SIZE];
+            std::memcpy(bad, good, sizeof(bad));
+            bad[byte] ^= static_cast<uint8_t>(1u << bit);
+
+            ControlPacket got;
+            got.sequence = 7;
+            CHECK(decodeControlPacket(bad, sizeof(bad), got) == ControlPacketStatus::BadCrc);
+            CHECK_EQ(got.sequence, 7u);
+        }
+    }
+}
+TEST(TEST_ControlPacketBadCrc);
+
+void TEST_ControlPacketTruncated() {
+    uint8_t datagram[CONTROL_PACKET_SIZE + 1];
+    encodeControlPacket(samplePacket(), datagram);
+
+    ControlPacket got;
+    for (size_t length = 2; length < CONTROL_PACKET_SIZE; ++length) {
+        CHECK(decodeControlPacket(datagram, length, got) == ControlPacketStatus::BadLength);
+    }
+    CHECK(decodeControlPacket(datagram, CONTROL_PACKET_SIZE + 1, got) == ControlPacketStatus::BadLength);
+
+    // Too short to even carry the magic: leave it to the JSON parser
+    CHECK(decodeControlPacket(datagram, 1, got) == ControlPacketStatus::NotBinary);
+    CHECK(decodeControlPacket(datagram, 0, got) == ControlPacketStatus::NotBinary);
+}
+TEST(TEST_ControlPacketTruncated);
+
+void TEST_ControlPacketNotBinaryOrBadVersion() {
+    const char json[] = "{\"joysticks\":{}}";
+    ControlPacket got;
+    CHECK(decodeControlPacket(reinterpret_cast<const uint8_t*>(json), sizeof(json) - 1, got)
+          == ControlPacketStatus::NotBinary);
+
+    uint8_t datagram[CONTROL_PACKET_SIZE];
+    encodeControlPacket(samplePacket(), datagram);
+    datagram[2] = 3;
+    CHECK(decodeControlPacket(datagram, sizeof(datagram), got) == ControlPacketStatus::BadVersion);
+}
+TEST(TEST_ControlPacketNotBinaryOrBadVersion);
+
+}  // namespace
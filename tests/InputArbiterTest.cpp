@@ -0,0 +1,148 @@
+#include "Test.hpp"
+#include "InputArbiter.hpp"
+#include <atomic>
+#include <thread>
+
+namespace {
+
+// A state whose left stick is deflected to `x` (outside the deadzone for
+// anything from ~1600 up)
+InputState stick(int16_t x, uint32_t buttons = 0) {
+    InputState state;
+    state.axes[Constants::JOYSTICK_AXIS_X] = x;
+    state.buttons = buttons;
+    return state;
+}
+
+void TEST_ArbiterPriority() {
+    InputArbiter arbiter;
+    CHECK(arbiter.snapshot().source == InputSource::None);
+
+    arbiter.setAutopilot(stick(100, 1));
+    CHECK(arbiter.snapshot().source == InputSource::Autopilot);
+    CHECK_EQ(arbiter.snapshot().axes[Constants::JOYSTICK_AXIS_X], 100);
+
+    arbiter.setClient(2, stick(200, 2), 0);
+    CHECK(arbiter.snapshot().source == InputSource::Udp);
+    CHECK_EQ(arbiter.snapshot().client, 2);
+    CHECK_EQ(arbiter.snapshot().buttons, 2u);
+
+    arbiter.setJoystick(stick(20000, 4), true);
+    CHECK(arbiter.snapshot().source == InputSource::Joystick);
+    CHECK_EQ(arbiter.snapshot().axes[Constants::JOYSTICK_AXIS_X], 20000);
+
+    // Back inside the deadzone, the stick yields; the buttons go with it
+    arbiter.setJoystick(stick(1500, 4), true);
+    CHECK(arbiter.snapshot().source == InputSource::Udp);
+    CHECK_EQ(arbiter.snapshot().buttons, 2u);
+
+    // A deflected but disconnected stick is ignored
+    arbiter.setJoystick(stick(20000), false);
+    CHECK(arbiter.snapshot().source == InputSource::Udp);
+
+    // Triggers rest at full negative and must not count as deflection
+    InputState triggers;
+    triggers.axes[2] = triggers.axes[5] = -Constants::MAX_JOYSTICK_VALUE;
+    arbiter.setJoystick(triggers, true);
+    CHECK(arbiter.snapshot().source == InputSource::Udp);
+
+    arbiter.dropClient(2);
+    CHECK(arbiter.snapshot().source == InputSource::Autopilot);
+    arbiter.clearAutopilot();
+    CHECK(arbiter.snapshot().source == InputSource::None);
+    CHECK_EQ(arbiter.snapshot().axes[Constants::JOYSTICK_AXIS_X], 0);
+    CHECK_EQ(arbiter.snapshot().buttons, 0u);
+}
+TEST(TEST_ArbiterPriority);
+
+// The owning client keeps control while it keeps sending, even when another
+// client is heard more recently
+void TEST_ArbiterStickyUdpOwner() {
+    InputArbiter arbiter;
+    arbiter.setClient(0, stick(1000), 0);
+    arbiter.setClient(1, stick(2000), 10);
+    CHECK_EQ(arbiter.snapshot().client, 0);
+    arbiter.setClient(0, stick(1100), 20);
+    arbiter.setClient(1, stick(2100), 30);
+    CHECK_EQ(arbiter.snapshot().client, 0);
+    CHECK_EQ(arbiter.snapshot().axes[Constants::JOYSTICK_AXIS_X], 1100);
+
+    // The owner's slot is reused: the most recently heard client takes over
+    arbiter.dropClient(0);
+    CHECK_EQ(arbiter.snapshot().client, 1);
+    CHECK_EQ(arbiter.snapshot().axes[Constants::JOYSTICK_AXIS_X], 2100);
+}
+TEST(TEST_ArbiterStickyUdpOwner);
+
+void TEST_ArbiterTimeoutHandover() {
+    const uint64_t watchdog = Constants::UDP_WATCHDOG_MS;
+    InputArbiter arbiter;
+    arbiter.setAutopilot(stick(100));
+    arbiter.setClient(0, stick(1000), 0);
+    arbiter.setClient(1, stick(2000), 300);
+
+    uint64_t nextExpiryMs = 0;
+    CHECK_EQ(arbiter.expire(watchdog - 1, nextExpiryMs), 0u);
+    CHECK_EQ(nextExpiryMs, 1u);
+    CHECK_EQ(arbiter.snapshot().client, 0);
+
+    // Owner falls silent: the other client takes over
+    CHECK_EQ(arbiter.expire(watchdog, nextExpiryMs), 1u);
+    CHECK_EQ(nextExpiryMs, 300u);
+    CHECK(arbiter.snapshot().source == InputSource::Udp);
+    CHECK_EQ(arbiter.snapshot().client, 1);
+
+    // A packet restarts that client's watchdog
+    arbiter.setClient(1, stick(2100), watchdog + 200);
+    CHECK_EQ(arbiter.expire(watchdog + 300, nextExpiryMs), 0u);
+    CHECK_EQ(nextExpiryMs, watchdog - 100);
+
+    // Last client gone: control falls back to the autopilot
+    CHECK_EQ(arbiter.expire(2 * watchdog + 200, nextExpiryMs), 1u);
+    CHECK_EQ(nextExpiryMs, 0u);
+    CHECK(arbiter.snapshot().source == InputSource::Autopilot);
+    CHECK_EQ(arbiter.snapshot().axes[Constants::JOYSTICK_AXIS_X], 100);
+}
+TEST(TEST_ArbiterTimeoutHandover);
+
+// Many words, each stamped with the same value by one store: a torn copy
+// would show two different stamps.  The payload and run are large enough
+// that a copy is regularly interrupted, even on a single core
+struct Stamped {
+    uint64_t words[32];
+};
+
+void TEST_SeqlockNeverMixesWrites() {
+    Seqlock<Stamped> lock;
+    CHECK_EQ(lock.version(), 0u);
+    CHECK_EQ(lock.load().words[31], 0u);
+
+    constexpr uint64_t STORES = 2000000;
+    std::atomic<bool> done{false};
+    std::thread writer([&] {
+        for (uint64_t n = 1; n <= STORES; ++n) {
+            Stamped value;
+            for (auto& word : value.words) word = n;
+            lock.store(value);
+        }
+        done.store(true);
+    });
+
+    uint64_t loads = 0, torn = 0, lastSeen = 0, backwards = 0;
+    while (!done.load() || loads == 0) {
+        const Stamped value = lock.load();
+        for (auto word : value.words) torn += word != value.words[0];
+        backwards += value.words[0] < lastSeen;
+        lastSeen = value.words[0];
+        ++loads;
+    }
+    writer.join();
+
+    CHECK_EQ(torn, 0u);
+    CHECK_EQ(backwards, 0u);
+    CHECK_EQ(lock.version(), static_cast<uint32_t>(STORES));
+    CHECK_EQ(lock.load().words[0], STORES);
+}
+TEST(TEST_SeqlockNeverMixesWrites);
+
+}  // namespace
@@ -0,0 +1,93 @@
+#include "Test.hpp"
+#include "ControlPacket.hpp"
+#include "InputManager.hpp"
+#include <cstring>
+#include <sstream>
+#include <string>
+
+// The UDP decode path end to end (binary first, JSON fallback), without a
+// socket: applyPacket() takes the same route as a received datagram.
+namespace {
+
+// Parse errors are logged; keep them out of the test output
+bool applyQuietly(InputManager& input, const std::string& datagram) {
+    std::ostringstream discard;
+    std::streambuf* saved = std::cerr.rdbuf(discard.rdbuf());
+    const bool accepted = input.applyPacket(datagram.data(), datagram.size());
+    std::cerr.rdbuf(saved);
+    return accepted;
+}
+
+std::string binaryDatagram(uint32_t sequence, int16_t leftX, int16_t leftY) {
+    ControlPacket packet;
+    packet.sequence = sequence;
+    packet.leftX = leftX;
+    packet.leftY = leftY;
+    packet.buttons = 0x3;
+    std::string datagram(CONTROL_PACKET_SIZE, '\0');
+    encodeControlPacket(packet, reinterpret_cast<uint8_t*>(datagram.data()));
+    return datagram;
+}
+
+// Binary y is up, like the JSON floats; the published axes use the
+// joystick's sense (y down)
+void TEST_InputBinaryPacketApplied() {
+    InputManager input;
+    CHECK(applyQuietly(input, binaryDatagram(1, 1000, 2000)));
+    const InputSnapshot snap = input.snapshot();
+    CHECK(snap.source == InputSource::Udp);
+    CHECK_EQ(snap.axes[Constants::JOYSTICK_AXIS_X], 1000);
+    CHECK_EQ(snap.axes[Constants::JOYSTICK_AXIS_Y], -2000);
+    CHECK_EQ(snap.buttons, 0x3u);
+}
+TEST(TEST_InputBinaryPacketApplied);
+
+// A damaged binary packet is dropped, never re-read as JSON
+void TEST_InputBinaryBadCrcAndTruncatedRejected() {
+    InputManager input;
+    CHECK(applyQuietly(input, binaryDatagram(1, 1000, 2000)));
+
+    std::string corrupt = binaryDatagram(2, -5000, 0);
+    corrupt[9] ^= 0x40;
+    CHECK(!applyQuietly(input, corrupt));
+    CHECK(!applyQuietly(input, binaryDatagram(3, -5000, 0).substr(0, CONTROL_PACKET_SIZE - 1)));
+    CHECK(!applyQuietly(input, binaryDatagram(4, -5000, 0).substr(0, 3)));
+    CHECK_EQ(input.snapshot().axes[Constants::JOYSTICK_AXIS_X], 1000);
+}
+TEST(TEST_InputBinaryBadCrcAndTruncatedRejected);
+
+void TEST_InputJsonRoundTrip() {
+    InputManager input;
+    CHECK(applyQuietly(input, R"({"seq":1,"joysticks":{"left":[0.5,-0.25],"right":[-1.0,1.0]}})"));
+    const InputSnapshot snap = input.snapshot();
+    CHECK_EQ(snap.axes[Constants::JOYSTICK_AXIS_X], Constants::MAX_JOYSTICK_VALUE / 2);
+    CHECK_EQ(snap.axes[Constants::JOYSTICK_AXIS_Y], Constants::MAX_JOYSTICK_VALUE / 4);
+    CHECK_EQ(snap.axes[Constants::JOYSTICK_AXIS_RX], -Constants::MAX_JOYSTICK_VALUE);
+    CHECK_EQ(snap.axes[Constants::JOYSTICK_AXIS_RY], -Constants::MAX_JOYSTICK_VALUE);
+
+    // Only the fields present change
+    CHECK(applyQuietly(input, R"({"seq":2,"joysticks":{"right":[0.0,0.0]}})"));
+    CHECK_EQ(input.snapshot().axes[Constants::JOYSTICK_AXIS_X], Constants::MAX_JOYSTICK_VALUE / 2);
+    CHECK_EQ(input.snapshot().axes[Constants::JOYSTICK_AXIS_RX], 0);
+
+    // Sequenced JSON is ordered like binary packets
+    CHECK(!applyQuietly(input, R"({"seq":1,"joysticks":{"left":[0.0,0.0]}})"));
+    CHECK_EQ(input.snapshot().axes[Constants::JOYSTICK_AXIS_X], Constants::MAX_JOYSTICK_VALUE / 2);
+}
+TEST(TEST_InputJsonRoundTrip);
+
+void TEST_InputJsonTruncatedOrMalformedRejected() {
+    InputManager input;
+    CHECK(applyQuietly(input, R"({"joysticks":{"left":[0.5,0.0]}})"));
+
+    const std::string full = R"({"joysticks":{"left":[-0.5,0.0]}})";
+    for (size_t length = 1; length < full.size(); ++length) {
+        CHECK(!applyQuietly(input, full.substr(0, length)));
+    }
+    CHECK(!applyQuietly(input, "not json"));
+    CHECK(!applyQuietly(input, ""));
+    CHECK_EQ(input.snapshot().axes[Constants::JOYSTICK_AXIS_X], Constants::MAX_JOYSTICK_VALUE / 2);
+}
+TEST(TEST_InputJsonTruncatedOrMalformedRejected);
+
+}  // namespace
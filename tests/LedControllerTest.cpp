@@ -0,0 +1,171 @@
+#include "Test.hpp"
+#include "LedController.hpp"
+#include <algorithm>
+#include <cmath>
+#include <fcntl.h>
+#include <sstream>
+
+// Drives the render thread's tick by hand; with no SPI device open every
+// transfer fails, but the frame counters still see each one.
+class LedControllerTest {
+public:
+    static void tick(LedController& leds) {
+        std::ostringstream discard;                 // "SPI transfer failed" per frame
+        std::streambuf* saved = std::cerr.rdbuf(discard.rdbuf());
+        leds.renderFrame(false);
+        std::cerr.rdbuf(saved);
+    }
+
+    // An open descriptor that is not spidev: stop() runs its full shutdown
+    // path, and the transfers fail harmlessly
+    static void attachNullDevice(LedController& leds) {
+        leds.spiFd = open("/dev/null", O_RDWR);
+    }
+
+    static void stop(LedController& leds) {
+        std::ostringstream discard;
+        std::streambuf* saved = std::cerr.rdbuf(discard.rdbuf());
+        leds.stop();
+        std::cerr.rdbuf(saved);
+    }
+
+    /// The encoded frame most recently handed to the SPI transfer.
+    static const std::vector<uint8_t>& lastSent(const LedController& leds) {
+        return leds.spiFrames[leds.backFrame ^ 1];
+    }
+};
+
+namespace {
+
+// Dim enough that the gamma stage leaves a fraction on every channel
+void fillDim(LedController& leds) {
+    for (uint16_t i = 0; i < leds.pixelCount(); ++i) leds.setPixel(i, 40, 41, 42);
+}
+
+// First channel on the strip (pixel 0 green), decoded from an Spi8Bit frame
+unsigned firstChannel(const std::vector<uint8_t>& frame) {
+    unsigned value = 0;
+    for (size_t bit = 0; bit < 8; ++bit) value = (value << 1) | (frame[bit] == 0xF0 ? 1 : 0);
+    return value;
+}
+
+// By default a static dim frame keeps dithering, and every cycle shows the
+// same average: the perceived level never steps
+void TEST_LedStaticDitherHoldsPerceivedLevel() {
+    constexpr unsigned CYCLE = Constants::LED_DITHER_CYCLE_FRAMES;
+    LedController leds(LedStripConfig{});
+    leds.setKeepAliveInterval(0);
+    leds.setDithering(true);
+    fillDim(leds);
+    leds.show();
+
+    // The strip shows the last frame sent; skipped ticks leave it in place
+    std::vector<unsigned> cycleSums;
+    for (unsigned cycle = 0; cycle < 40; ++cycle) {
+        unsigned sum = 0;
+        for (unsigned i = 0; i < CYCLE; ++i) {
+            LedControllerTest::tick(leds);
+            sum += firstChannel(LedControllerTest::lastSent(leds));
+        }
+        cycleSums.push_back(sum);
+    }
+    for (unsigned sum : cycleSums) CHECK_EQ(sum, cycleSums.front());
+
+    // …and that average is the gamma-corrected level to within 1/CYCLE
+    const double level = std::pow(41 / 255.0, Constants::LED_GAMMA_GREEN) * Constants::LED_DEFAULT_BRIGHTNESS;
+    CHECK_LE(std::abs(cycleSums.back() / double(CYCLE) - level), 1.0 / CYCLE);
+    CHECK_NE(std::floor(level), level);                 // the test needs a fraction
+
+    // Still dithering: the cycle keeps going out
+    const uint64_t sent = leds.framesSent();
+    for (unsigned i = 0; i < CYCLE; ++i) LedControllerTest::tick(leds);
+    CHECK_GT(leds.framesSent(), sent);
+}
+TEST(TEST_LedStaticDitherHoldsPerceivedLevel);
+
+// With a settle limit, a static dithered frame is rounded once and then
+// produces no more SPI writes
+void TEST_LedDitherSettleStopsSending() {
+    constexpr unsigned SETTLE = 32;
+    LedController leds(LedStripConfig{});
+    leds.setKeepAliveInterval(0);
+    leds.setDithering(true);
+    leds.setDitherSettleFrames(SETTLE);
+    fillDim(leds);
+    leds.show();
+
+    for (unsigned i = 0; i < SETTLE + 2; ++i) LedControllerTest::tick(leds);
+    const uint64_t settled = leds.framesSent();
+    CHECK_GT(settled, 2u);
+    CHECK_LE(settled, SETTLE + 1);
+
+    // Nothing more on the bus, even with the same face redrawn every tick
+    for (unsigned i = 0; i < 100; ++i) {
+        if (i % 2 == 0) {
+            fillDim(leds);
+            leds.show();
+        }
+        LedControllerTest::tick(leds);
+    }
+    CHECK_EQ(leds.framesSent(), settled);
+
+    // A real change restarts the dither
+    leds.setPixel(0, 90, 0, 0);
+    leds.show();
+    LedControllerTest::tick(leds);
+    CHECK_GT(leds.framesSent(), settled);
+}
+TEST(TEST_LedDitherSettleStopsSending);
+
+// Levels the gamma stage hits exactly have nothing to dither: sent once
+void TEST_LedStaticExactFrameSendsOnce() {
+    LedController leds(LedStripConfig{});
+    leds.setKeepAliveInterval(0);
+    leds.setDithering(true);
+    leds.setBrightness(255);
+    for (uint16_t i = 0; i < leds.pixelCount(); ++i) {
+        leds.setPixel(i, i % 2 ? 255 : 0, 0, 255);
+    }
+    leds.show();
+
+    for (unsigned i = 0; i < 50; ++i) LedControllerTest::tick(leds);
+    CHECK_EQ(leds.framesSent(), 1u);
+}
+TEST(TEST_LedStaticExactFrameSendsOnce);
+
+void TEST_LedStaticFrameWithoutDitherSendsOnce() {
+    LedController leds(LedStripConfig{});
+    leds.setKeepAliveInterval(0);
+    leds.setDithering(false);
+    fillDim(leds);
+    leds.show();
+
+    for (unsigned i = 0; i < 50; ++i) LedControllerTest::tick(leds);
+    CHECK_EQ(leds.framesSent(), 1u);
+}
+TEST(TEST_LedStaticFrameWithoutDitherSendsOnce);
+
+// Spi8Bit: every colour bit is one byte, 0xF0 for a 1
+bool anyBitSet(const std::vector<uint8_t>& frame) {
+    return std::find(frame.begin(), frame.end(), 0xF0) != frame.end();
+}
+
+// Effects composite over show()'s frame; the shutdown frame must not
+void TEST_LedStopSendsDarkFrameWithEffects() {
+    LedController leds(LedStripConfig{});
+    LedEffect solid;
+    solid.colour = {255, 255, 255};
+    leds.effects().add(solid);
+    LedControllerTest::attachNullDevice(leds);
+
+    LedControllerTest::tick(leds);
+    CHECK(anyBitSet(LedControllerTest::lastSent(leds)));
+
+    const uint64_t sent = leds.framesSent();
+    LedControllerTest::stop(leds);
+    CHECK_EQ(leds.framesSent(), sent + 1);
+    CHECK(!anyBitSet(LedControllerTest::lastSent(leds)));
+}
+TEST(TEST_LedStopSendsDarkFrameWithEffects);
+
+}  // namespace
@@ -0,0 +1,39 @@
+#include "Test.hpp"
+#include "LedEffects.hpp"
+#include <array>
+
+namespace {
+
+// Edits made between frames show up on the next render(), in order
+void TEST_LedEffectEditsReachRender() {
+    LedEffectEngine engine;
+    std::array<Pixel, 8> frame{};
+
+    LedEffect red;
+    red.colour = {200, 0, 0};
+    const int id = engine.add(red);
+    CHECK_GE(id, 0);
+    CHECK(!engine.empty());
+    engine.render(frame.data(), frame.size(), 0);
+    CHECK_EQ(frame[0].r, 200);
+
+    // Several edits before one frame: only the newest table is used
+    LedEffect green;
+    green.colour = {0, 100, 0};
+    green.start = 4;
+    engine.add(green);
+    engine.remove(id);
+    frame.fill(Pixel{});
+    engine.render(frame.data(), frame.size(), 0);
+    CHECK_EQ(frame[0].r, 0);
+    CHECK_EQ(frame[4].g, 100);
+
+    engine.clear();
+    CHECK(engine.empty());
+    frame.fill(Pixel{});
+    engine.render(frame.data(), frame.size(), 0);
+    CHECK_EQ(frame[4].g, 0);
+}
+TEST(TEST_LedEffectEditsReachRender);
+
+}  // namespace
@@ -0,0 +1,101 @@
+#include "Test.hpp"
+#include "LinkQuality.hpp"
+#include "Constants.hpp"
+
+namespace {
+
+constexpr uint64_t PERIOD_US = 20'000;                  // 50 Hz sender
+constexpr uint32_t CLOCK_OFFSET_US = 123'456'789;       // sender clock vs ours
+
+// One sender: packet n is sent at n × PERIOD_US on its clock and arrives
+// transitUs later on ours.
+struct Sender {
+    LinkQuality link;
+    uint64_t baseUs = 5'000'000;
+
+    LinkQuality::Verdict send(uint32_t sequence, uint64_t transitUs = 2'000) {
+        const uint64_t sentOursUs = baseUs + sequence * PERIOD_US;
+        const uint32_t sentUs = static_cast<uint32_t>(sentOursUs + CLOCK_OFFSET_US);
+        return link.onPacket(sequence, true, sentUs, sentOursUs + transitUs);
+    }
+};
+
+void TEST_LinkInOrderAccepted() {
+    Sender sender;
+    for (uint32_t seq = 1; seq <= 50; ++seq) {
+        CHECK(sender.send(seq) == LinkQuality::Verdict::Accept);
+    }
+    const LinkStats stats = sender.link.snapshot();
+    CHECK_EQ(stats.received, 50u);
+    CHECK_EQ(stats.lost, 0u);
+    CHECK_EQ(stats.reordered, 0u);
+    CHECK_EQ(stats.stale, 0u);
+    CHECK_LE(stats.delayMs, 0.001f);
+}
+TEST(TEST_LinkInOrderAccepted);
+
+// A late or duplicate sequence is dropped without counting as loss
+void TEST_LinkReorderedAndDuplicateDropped() {
+    Sender sender;
+    CHECK(sender.send(1) == LinkQuality::Verdict::Accept);
+    CHECK(sender.send(2) == LinkQuality::Verdict::Accept);
+    CHECK(sender.send(4) == LinkQuality::Verdict::Accept);
+    // Arrival order is the receive order: the stragglers took longer
+    CHECK(sender.send(3, 2'000 + 2 * PERIOD_US) == LinkQuality::Verdict::Reordered);
+    CHECK(sender.send(4, 2'000 + 2 * PERIOD_US) == LinkQuality::Verdict::Reordered);
+    CHECK(sender.send(5, 2'000 + PERIOD_US) == LinkQuality::Verdict::Accept);
+
+    const LinkStats stats = sender.link.snapshot();
+    CHECK_EQ(stats.received, 4u);
+    CHECK_EQ(stats.reordered, 2u);
+    CHECK_EQ(stats.lost, 1u);                           // 3 never arrived in order
+}
+TEST(TEST_LinkReorderedAndDuplicateDropped);
+
+void TEST_LinkLossCounted() {
+    Sender sender;
+    for (uint32_t seq = 1; seq <= 100; seq += (seq % 10 == 0) ? 3 : 1) {
+        sender.send(seq);
+    }
+    const LinkStats stats = sender.link.snapshot();
+    CHECK_GE(stats.lost, 18u);
+    CHECK_GT(stats.lossRate, 0.0f);
+    CHECK_LE(stats.lossRate, 0.5f);
+}
+TEST(TEST_LinkLossCounted);
+
+// One packet stuck in a queue is stale; the stream around it is fine
+void TEST_LinkDelaySpikeIsStale() {
+    Sender sender;
+    for (uint32_t seq = 1; seq <= 10; ++seq) sender.send(seq);
+    const uint64_t lateUs = (Constants::UDP_STALE_PACKET_MS + 50) * 1000ull;
+    CHECK(sender.send(11, lateUs) == LinkQuality::Verdict::Stale);
+    CHECK(sender.send(12) == LinkQuality::Verdict::Accept);
+    CHECK_EQ(sender.link.snapshot().stale, 1u);
+}
+TEST(TEST_LinkDelaySpikeIsStale);
+
+// A lasting step up in transit (clock stepped back, new route) is taken
+// as the new baseline after a short run, not rejected until silence
+void TEST_LinkTransitStepRebaselines() {
+    Sender sender;
+    for (uint32_t seq = 1; seq <= 10; ++seq) sender.send(seq);
+
+    const uint64_t steppedUs = 2'000 + (Constants::UDP_STALE_PACKET_MS + 300) * 1000ull;
+    uint32_t seq = 11;
+    unsigned stale = 0;
+    while (sender.send(seq++, steppedUs) == LinkQuality::Verdict::Stale) {
+        if (++stale > Constants::UDP_STALE_REBASELINE_PACKETS) break;
+    }
+    CHECK_EQ(stale, Constants::UDP_STALE_REBASELINE_PACKETS - 1);
+
+    for (unsigned i = 0; i < 20; ++i) {
+        CHECK(sender.send(seq++, steppedUs) == LinkQuality::Verdict::Accept);
+    }
+    const LinkStats stats = sender.link.snapshot();
+    CHECK_EQ(stats.lost, 0u);
+    CHECK_LE(stats.delayMs, 0.001f);
+}
+TEST(TEST_LinkTransitStepRebaselines);
+
+}  // namespace
@@ -0,0 +1,220 @@
+#include "Test.hpp"
+#include "MotorController.hpp"
+#include "SimulatedGpioBackend.hpp"
+#include <cmath>
+#include <memory>
+
+namespace {
+
+constexpr uint64_t NS_PER_SEC = 1'000'000'000;
+constexpr uint64_t NS_PER_US = 1'000;
+constexpr int16_t SPEED = 500;                          // steps/s
+constexpr uint64_t INTERVAL_NS = NS_PER_SEC / SPEED;
+
+// Pan axis on the simulated clock, stepped by hand: every call to run()
+// advances virtual time and returns once the scheduler has caught up.
+// Pulse-train waves carry whole microseconds, so their edges may land up
+// to slackNs before the ideal deadline.
+struct PanRig {
+    SimulatedGpioBackend* sim;
+    MotorController motors;
+    uint64_t slackNs;
+
+    explicit PanRig(PulseMode mode = PulseMode::Direct)
+        : PanRig(std::make_unique<SimulatedGpioBackend>(), mode) {}
+
+    PanRig(std::unique_ptr<SimulatedGpioBackend> backend, PulseMode mode)
+        : sim(backend.get()), motors(std::move(backend)),
+          slackNs(mode == PulseMode::PulseTrain ? NS_PER_US : 0)
+    {
+        sim->setHorizonNs(0);
+        motors.setPulseMode(mode);
+        motors.initialize();
+        sim->waitForHorizon();
+    }
+
+    void run(uint64_t ns) {
+        sim->advanceNs(ns);
+        sim->waitForHorizon();
+    }
+
+    // Steps played so far (pulse-train windows are recorded ahead)
+    std::vector<uint64_t> stepTimes() const {
+        std::vector<uint64_t> times;
+        for (const auto& edge : sim->edgesFor(Constants::MOTOR_PAN_PULSE)) {
+            if (edge.level == 1 && edge.timeNs <= sim->nowNs()) times.push_back(edge.timeNs);
+        }
+        return times;
+    }
+};
+
+uint64_t minSpacingNs(const std::vector<uint64_t>& times) {
+    uint64_t spacing = UINT64_MAX;
+    for (size_t i = 1; i < times.size(); ++i) spacing = std::min(spacing, times[i] - times[i - 1]);
+    return spacing;
+}
+
+// Ramp up, then cruise: over two seconds the step count is the cruise
+// distance less what the ramp gave up, and no step comes early.
+void checkFixedSpeed(PulseMode mode) {
+    PanRig rig(mode);
+    rig.motors.setSpeed(MotorController::PAN, SPEED);
+    rig.run(2 * NS_PER_SEC);
+
+    const auto steps = rig.stepTimes();
+    const uint64_t rampNs = NS_PER_SEC * SPEED / Constants::TURRET_ACCELERATION;
+    const uint64_t expected = SPEED * 2 - SPEED * rampNs / NS_PER_SEC / 2;
+    CHECK_GE(steps.size(), expected - expected / 20);
+    CHECK_LE(steps.size(), static_cast<size_t>(SPEED * 2));
+    CHECK_GE(rig.motors.stepStats(MotorController::PAN).steps, steps.size());
+    CHECK_GE(minSpacingNs(steps) + rig.slackNs, INTERVAL_NS);
+
+    // The first step waits out the driver's enable setup time
+    const auto enable = rig.sim->edgesFor(Constants::MOTOR_PAN_ENABLE);
+    CHECK(!enable.empty());
+    if (!enable.empty() && !steps.empty()) {
+        CHECK_GE(steps.front() - enable.back().timeNs, Constants::DIR_SETUP_US * NS_PER_US);
+    }
+
+    rig.motors.stop();
+}
+
+void TEST_MotorFixedSpeedStepCountAndSpacing() {
+    checkFixedSpeed(PulseMode::Direct);
+}
+TEST(TEST_MotorFixedSpeedStepCountAndSpacing);
+
+void TEST_MotorPulseTrainFixedSpeed() {
+    checkFixedSpeed(PulseMode::PulseTrain);
+}
+TEST(TEST_MotorPulseTrainFixedSpeed);
+
+// Reversing decelerates to rest, flips DIR with the pulse line low, and
+// only steps again after the setup time.
+void checkReversal(PulseMode mode) {
+    PanRig rig(mode);
+    rig.motors.setSpeed(MotorController::PAN, SPEED);
+    rig.run(NS_PER_SEC);
+    const uint64_t reversedAtNs = rig.sim->nowNs();
+    rig.motors.setSpeed(MotorController::PAN, -SPEED);
+    rig.run(NS_PER_SEC);
+
+    std::vector<GpioEdge> dirChanges;
+    for (const auto& edge : rig.sim->edgesFor(Constants::MOTOR_PAN_DIRECTION)) {
+        if (edge.timeNs >= reversedAtNs) dirChanges.push_back(edge);
+    }
+    CHECK_EQ(dirChanges.size(), 1u);
+    if (dirChanges.size() != 1) {
+        rig.motors.stop();
+        return;
+    }
+    const GpioEdge flip = dirChanges.front();
+    CHECK_EQ(flip.level, 0);
+
+    const auto pulses = rig.sim->edgesFor(Constants::MOTOR_PAN_PULSE);
+    int levelAtFlip = 0;
+    uint64_t firstAfterNs = 0;
+    size_t stepsAfter = 0;
+    for (const auto& edge : pulses) {
+        if (edge.timeNs <= flip.timeNs) {
+            levelAtFlip = edge.level;
+        } else if (edge.level == 1) {
+            if (stepsAfter++ == 0) firstAfterNs = edge.timeNs;
+        }
+    }
+    CHECK_EQ(levelAtFlip, 0);
+    CHECK_GT(stepsAfter, 0u);
+    CHECK_GE(firstAfterNs - flip.timeNs, Constants::DIR_SETUP_US * NS_PER_US);
+
+    // Slowing down and speeding up again never beats the cruise interval
+    CHECK_GE(minSpacingNs(rig.stepTimes()) + rig.slackNs, INTERVAL_NS);
+
+    rig.motors.stop();
+}
+
+void TEST_MotorDirectionReversal() {
+    checkReversal(PulseMode::Direct);
+}
+TEST(TEST_MotorDirectionReversal);
+
+void TEST_MotorPulseTrainDirectionReversal() {
+    checkReversal(PulseMode::PulseTrain);
+}
+TEST(TEST_MotorPulseTrainDirectionReversal);
+
+// A slower target (or a stop) lets the queued step fall due at its
+// planned time; only a faster one may pull it in.
+void checkSlowerCommand(int16_t slower) {
+    constexpr int16_t CRUISE = 80;
+    constexpr uint64_t CRUISE_NS = NS_PER_SEC / CRUISE;
+
+    PanRig rig;
+    rig.motors.setSpeed(MotorController::PAN, CRUISE);
+    rig.run(2 * NS_PER_SEC + CRUISE_NS / 3);            // park between two steps
+    rig.motors.setSpeed(MotorController::PAN, slower);
+    rig.run(NS_PER_SEC);
+
+    CHECK_GE(minSpacingNs(rig.stepTimes()), CRUISE_NS);
+    rig.motors.stop();
+}
+
+void TEST_MotorStopNeverShrinksSpacing() {
+    checkSlowerCommand(0);
+}
+TEST(TEST_MotorStopNeverShrinksSpacing);
+
+void TEST_MotorSlowDownNeverShrinksSpacing() {
+    checkSlowerCommand(60);
+}
+TEST(TEST_MotorSlowDownNeverShrinksSpacing);
+
+void TEST_MotorSpeedUpPullsQueuedStepIn() {
+    constexpr uint64_t SLOW_NS = NS_PER_SEC / 80;
+
+    PanRig rig;
+    rig.motors.setSpeed(MotorController::PAN, 80);
+    rig.run(2 * NS_PER_SEC + SLOW_NS / 3);
+    const size_t before = rig.stepTimes().size();
+    const uint64_t lastNs = rig.stepTimes().back();
+    rig.motors.setSpeed(MotorController::PAN, SPEED);
+    rig.run(NS_PER_SEC);
+
+    const auto steps = rig.stepTimes();
+    CHECK_GT(steps.size(), before);
+    if (steps.size() > before) CHECK_LE(steps[before] - lastNs, SLOW_NS);
+    rig.motors.stop();
+}
+TEST(TEST_MotorSpeedUpPullsQueuedStepIn);
+
+// A move queued behind the active one keeps isMoving() up until it has
+// finished too; no wheel steps while it reads false.
+void TEST_MotorQueuedMoveStaysMoving() {
+    PanRig rig;
+    rig.motors.moveRelative(100.0, 0.0);
+    rig.run(50'000'000);
+    CHECK(rig.motors.isMoving());
+    rig.motors.moveRelative(100.0, 0.0);
+
+    uint64_t stepsWhileIdle = 0;
+    uint64_t lastSteps = rig.motors.stepStats(MotorController::LEFT).steps;
+    bool wasMoving = true;
+    for (int i = 0; i < 300; ++i) {
+        rig.run(10'000'000);
+        const uint64_t steps = rig.motors.stepStats(MotorController::LEFT).steps;
+        if (!wasMoving) stepsWhileIdle += steps - lastSteps;
+        lastSteps = steps;
+        wasMoving = rig.motors.isMoving();
+    }
+    rig.run(NS_PER_SEC);
+
+    const uint64_t expected = 2 * static_cast<uint64_t>(std::lround(
+        100.0 * Constants::DRIVE_STEPS_PER_REV / (M_PI * Constants::DRIVE_WHEEL_DIAMETER_MM)));
+    CHECK(!rig.motors.isMoving());
+    CHECK_EQ(rig.motors.stepStats(MotorController::LEFT).steps, expected);
+    CHECK_EQ(rig.motors.stepStats(MotorController::LEFT).steps, lastSteps);
+    CHECK_EQ(stepsWhileIdle, 0u);
+    rig.motors.stop();
+}
+TEST(TEST_MotorQueuedMoveStaysMoving);
+
+}  // namespace
@@ -0,0 +1,52 @@
+#include "Test.hpp"
+#include <algorithm>
+#include <cstring>
+#include <vector>
+
+namespace {
+    struct Entry {
+        const char* name;
+        test::TestFn fn;
+    };
+
+    std::vector<Entry>& registry() {
+        static std::vector<Entry> entries;
+        return entries;
+    }
+
+    unsigned failures = 0;
+}
+
+namespace test {
+
+Registration::Registration(const char* name, TestFn fn) {
+    registry().push_back({name, fn});
+}
+
+void fail(const char* file, int line, const char* expression) {
+    ++failures;
+    std::cerr << file << ':' << line << ": CHECK(" << expression << ") failed\n";
+}
+
+}  // namespace test
+
+// Usage: stepper_tests [name-filter]
+int main(int argc, char* argv[]) {
+    const char* filter = argc > 1 ? argv[1] : nullptr;
+
+    auto& entries = registry();
+    std::sort(entries.begin(), entries.end(),
+              [](const Entry& a, const Entry& b) { return std::strcmp(a.name, b.name) < 0; });
+
+    unsigned run = 0;
+    for (const auto& entry : entries) {
+        if (filter && !std::strstr(entry.name, filter)) continue;
+        const unsigned before = failures;
+        entry.fn();
+        ++run;
+        std::cout << (failures == before ? "[  OK  ] " : "[ FAIL ] ") << entry.name << '\n';
+    }
+
+    std::cout << run << " test(s), " << failures << " failed check(s)\n";
+    return failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,49 @@
+#pragma once
+#include <iostream>
+
+// ─── Minimal in-house test harness ──────────────────────────────────────────
+//
+//  Same shape as bench/Benchmark.hpp: each test is a registered function;
+//  CHECK() records a failure and carries on, so one run reports every
+//  broken expectation.  The runner exits non-zero if any check failed.
+//
+//      void TEST_Something() {
+//          CHECK(work() == 42);
+//          CHECK_GE(elapsed, minimum);
+//      }
+//      TEST(TEST_Something);
+//
+namespace test {
+
+using TestFn = void (*)();
+
+struct Registration {
+    Registration(const char* name, TestFn fn);
+};
+
+/// Record a failed check (use the CHECK macros).
+void fail(const char* file, int line, const char* expression);
+
+}  // namespace test
+
+#define TEST(fn) static ::test::Registration fn##Registration(#fn, fn)
+
+#define CHECK(cond) \
+    do { if (!(cond)) ::test::fail(__FILE__, __LINE__, #cond); } while (0)
+
+// Comparisons also print both sides
+#define CHECK_OP(a, op, b) \
+    do { \
+        const auto checkA = (a); \
+        const auto checkB = (b); \
+        if (!(checkA op checkB)) { \
+            ::test::fail(__FILE__, __LINE__, #a " " #op " " #b); \
+            std::cerr << "    with " << checkA << " vs " << checkB << '\n'; \
+        } \
+    } while (0)
+
+#define CHECK_EQ(a, b) CHECK_OP(a, ==, b)
+#define CHECK_NE(a, b) CHECK_OP(a, !=, b)
+#define CHECK_GE(a, b) CHECK_OP(a, >=, b)
+#define CHECK_GT(a, b) CHECK_OP(a, >, b)
+#define CHECK_LE(a, b) CHECK_OP(a, <=, b)